@@ -447,10 +447,18 @@ void AutoType::performGlobalAutoType(const QList<QSharedPointer<Database>>& dbLi
     bool hideExpired = config()->get(Config::AutoTypeHideExpiredEntry).toBool();
 
     for (const auto& db : dbList) {
-        const QList<Entry*> dbEntries = db->rootGroup()->entriesRecursive();
-        for (auto entry : dbEntries) {
-            auto group = entry->group();
-            if (!group || !group->resolveAutoTypeEnabled() || !entry->autoTypeEnabled()) {
+        // Only look at entries which can match the window title at all
+        QHash<const Group*, bool> groupEnabled;
+        for (auto entry : db->findAutoTypeCandidates(m_windowTitleForGlobal)) {
+            const Group* group = entry->group();
+            if (!groupEnabled.contains(group)) {
+                groupEnabled.insert(group, group->resolveAutoTypeEnabled());
+            }
+            if (!groupEnabled.value(group)) {
+                continue;
+            }
+
+            if (!entry->autoTypeEnabled()) {
                 continue;
             }
 
@@ -588,7 +588,7 @@ QJsonObject BrowserAction::handlePasskeysRegister(const QJsonObject& json, const
 
 QJsonObject BrowserAction::decryptMessage(const QString& message, const QString& nonce)
 {
-    return browserMessageBuilder()->decryptMessage(message, nonce, m_clientPublicKey, m_secretKey);
+    return browserMessageBuilder()->decryptMessage(message, nonce, sharedKey());
 }
 
 QJsonObject BrowserAction::getErrorReply(const QString& action, const int errorCode) const
@@ -598,7 +598,7 @@ QJsonObject BrowserAction::getErrorReply(const QString& action, const int errorC
 
 QJsonObject BrowserAction::buildResponse(const QString& action, const QString& nonce, const Parameters& params)
 {
-    return browserMessageBuilder()->buildResponse(action, nonce, params, m_clientPublicKey, m_secretKey);
+    return browserMessageBuilder()->buildResponse(action, nonce, params, sharedKey());
 }
 
 BrowserRequest BrowserAction::decodeRequest(const QJsonObject& json)
@@ -612,6 +612,19 @@ BrowserRequest BrowserAction::decodeRequest(const QJsonObject& json)
             decryptMessage(encrypted, nonce)};
 }
 
+/**
+ * Shared key of the current client and our key pair, recomputed only when one of the keys changes.
+ */
+const SharedKey& BrowserAction::sharedKey()
+{
+    if (m_sharedKeyClientPublicKey != m_clientPublicKey || m_sharedKeySecretKey != m_secretKey) {
+        m_sharedKey = browserMessageBuilder()->getSharedKey(m_clientPublicKey, m_secretKey);
+        m_sharedKeyClientPublicKey = m_clientPublicKey;
+        m_sharedKeySecretKey = m_secretKey;
+    }
+    return m_sharedKey;
+}
+
 StringPairList BrowserAction::getConnectionKeys(const BrowserRequest& browserRequest)
 {
     const auto keys = browserRequest.getArray("keys");
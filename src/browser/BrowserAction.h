@@ -90,6 +90,7 @@ private:
     QJsonObject decryptMessage(const QString& message, const QString& nonce);
     BrowserRequest decodeRequest(const QJsonObject& json);
     StringPairList getConnectionKeys(const BrowserRequest& browserRequest);
+    const SharedKey& sharedKey();
 
 private:
     static const int MaxUrlLength;
@@ -99,6 +100,11 @@ private:
     QString m_secretKey;
     bool m_associated = false;
 
+    // Key agreement result for the current key pair, computed on first use
+    SharedKey m_sharedKey;
+    QString m_sharedKeyClientPublicKey;
+    QString m_sharedKeySecretKey;
+
     friend class TestBrowser;
 };
 
@@ -81,14 +81,16 @@ void BrowserHost::readProxyMessage()
         setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
     }
 
-    QJsonParseError error;
-    auto json = QJsonDocument::fromJson(socket->readAll(), &error);
-    if (json.isNull()) {
-        qWarning() << "Failed to read proxy message: " << error.errorString();
-        return;
+    for (const auto& message : BrowserShared::splitMessages(socket->readAll())) {
+        QJsonParseError error;
+        auto json = QJsonDocument::fromJson(message, &error);
+        if (json.isNull()) {
+            qWarning() << "Failed to read proxy message: " << error.errorString();
+            continue;
+        }
+
+        emit clientMessageReceived(socket, json.object());
     }
-
-    emit clientMessageReceived(socket, json.object());
 }
 
 void BrowserHost::broadcastClientMessage(const QJsonObject& json)
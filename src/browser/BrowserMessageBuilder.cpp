@@ -16,7 +16,6 @@
  */
 
 #include "BrowserMessageBuilder.h"
-#include "BrowserShared.h"
 #include "config-keepassx.h"
 #include "core/Global.h"
 
@@ -73,6 +72,14 @@ QJsonObject BrowserMessageBuilder::buildResponse(const QString& action,
                                                  const Parameters& params,
                                                  const QString& publicKey,
                                                  const QString& secretKey)
+{
+    return buildResponse(action, nonce, params, getSharedKey(publicKey, secretKey));
+}
+
+QJsonObject BrowserMessageBuilder::buildResponse(const QString& action,
+                                                 const QString& nonce,
+                                                 const Parameters& params,
+                                                 const SharedKey& sharedKey)
 {
     auto message = buildMessage(nonce);
 
@@ -81,7 +88,7 @@ QJsonObject BrowserMessageBuilder::buildResponse(const QString& action,
         message[i.key()] = QJsonValue::fromVariant(i.value());
     }
 
-    const auto encryptedMessage = encryptMessage(message, nonce, publicKey, secretKey);
+    const auto encryptedMessage = encryptMessage(message, nonce, sharedKey);
     if (encryptedMessage.isEmpty()) {
         return getErrorReply(action, ERROR_KEEPASS_CANNOT_ENCRYPT_MESSAGE);
     }
@@ -137,6 +144,13 @@ QString BrowserMessageBuilder::encryptMessage(const QJsonObject& message,
                                               const QString& nonce,
                                               const QString& publicKey,
                                               const QString& secretKey)
+{
+    return encryptMessage(message, nonce, getSharedKey(publicKey, secretKey));
+}
+
+QString BrowserMessageBuilder::encryptMessage(const QJsonObject& message,
+                                              const QString& nonce,
+                                              const SharedKey& sharedKey)
 {
     if (message.isEmpty() || nonce.isEmpty()) {
         return {};
@@ -144,7 +158,7 @@ QString BrowserMessageBuilder::encryptMessage(const QJsonObject& message,
 
     const QString reply(QJsonDocument(message).toJson());
     if (!reply.isEmpty()) {
-        return encrypt(reply, nonce, publicKey, secretKey);
+        return encrypt(reply, nonce, sharedKey);
     }
 
     return {};
@@ -154,12 +168,18 @@ QJsonObject BrowserMessageBuilder::decryptMessage(const QString& message,
                                                   const QString& nonce,
                                                   const QString& publicKey,
                                                   const QString& secretKey)
+{
+    return decryptMessage(message, nonce, getSharedKey(publicKey, secretKey));
+}
+
+QJsonObject
+BrowserMessageBuilder::decryptMessage(const QString& message, const QString& nonce, const SharedKey& sharedKey)
 {
     if (message.isEmpty() || nonce.isEmpty()) {
         return {};
     }
 
-    QByteArray ba = decrypt(message, nonce, publicKey, secretKey);
+    QByteArray ba = decrypt(message, nonce, sharedKey);
     if (ba.isEmpty()) {
         return {};
     }
@@ -172,54 +192,88 @@ QString BrowserMessageBuilder::encrypt(const QString& plaintext,
                                        const QString& publicKey,
                                        const QString& secretKey)
 {
-    const QByteArray ma = plaintext.toUtf8();
-    const QByteArray na = base64Decode(nonce);
+    return encrypt(plaintext, nonce, getSharedKey(publicKey, secretKey));
+}
+
+QByteArray BrowserMessageBuilder::decrypt(const QString& encrypted,
+                                          const QString& nonce,
+                                          const QString& publicKey,
+                                          const QString& secretKey)
+{
+    return decrypt(encrypted, nonce, getSharedKey(publicKey, secretKey));
+}
+
+/**
+ * Precompute the key shared by the owners of both key pairs.
+ *
+ * The result can be used for all messages exchanged with the client, which saves
+ * the key agreement on every single message.
+ *
+ * @param publicKey base64 encoded public key of the other party
+ * @param secretKey base64 encoded own secret key
+ * @return shared key, or an empty key if one of the keys is invalid
+ */
+SharedKey BrowserMessageBuilder::getSharedKey(const QString& publicKey, const QString& secretKey)
+{
     const QByteArray ca = base64Decode(publicKey);
     const QByteArray sa = base64Decode(secretKey);
 
-    std::vector<unsigned char> m(ma.cbegin(), ma.cend());
-    std::vector<unsigned char> n(na.cbegin(), na.cend());
     std::vector<unsigned char> ck(ca.cbegin(), ca.cend());
-    std::vector<unsigned char> sk(sa.cbegin(), sa.cend());
+    SharedKey sk(sa.cbegin(), sa.cend());
+
+    if (ck.size() != crypto_box_PUBLICKEYBYTES || sk.size() != crypto_box_SECRETKEYBYTES) {
+        return {};
+    }
+
+    SharedKey sharedKey(crypto_box_BEFORENMBYTES);
+    if (crypto_box_beforenm(sharedKey.data(), ck.data(), sk.data()) != 0) {
+        return {};
+    }
+
+    return sharedKey;
+}
 
-    std::vector<unsigned char> e;
-    e.resize(BrowserShared::NATIVEMSG_MAX_LENGTH);
+QString BrowserMessageBuilder::encrypt(const QString& plaintext, const QString& nonce, const SharedKey& sharedKey)
+{
+    const QByteArray ma = plaintext.toUtf8();
+    const QByteArray na = base64Decode(nonce);
 
-    if (m.empty() || n.empty() || ck.empty() || sk.empty()) {
+    if (ma.isEmpty() || na.size() != static_cast<int>(crypto_box_NONCEBYTES)
+        || sharedKey.size() != crypto_box_BEFORENMBYTES) {
         return {};
     }
 
-    if (crypto_box_easy(e.data(), m.data(), m.size(), n.data(), ck.data(), sk.data()) == 0) {
-        QByteArray res = getQByteArray(e.data(), (crypto_box_MACBYTES + ma.length()));
-        return res.toBase64();
+    std::vector<unsigned char> e(crypto_box_MACBYTES + ma.size());
+    if (crypto_box_easy_afternm(e.data(),
+                                reinterpret_cast<const unsigned char*>(ma.constData()),
+                                ma.size(),
+                                reinterpret_cast<const unsigned char*>(na.constData()),
+                                sharedKey.data())
+        == 0) {
+        return getQByteArray(e.data(), e.size()).toBase64();
     }
 
     return {};
 }
 
-QByteArray BrowserMessageBuilder::decrypt(const QString& encrypted,
-                                          const QString& nonce,
-                                          const QString& publicKey,
-                                          const QString& secretKey)
+QByteArray BrowserMessageBuilder::decrypt(const QString& encrypted, const QString& nonce, const SharedKey& sharedKey)
 {
     const QByteArray ma = base64Decode(encrypted);
     const QByteArray na = base64Decode(nonce);
-    const QByteArray ca = base64Decode(publicKey);
-    const QByteArray sa = base64Decode(secretKey);
-
-    std::vector<unsigned char> m(ma.cbegin(), ma.cend());
-    std::vector<unsigned char> n(na.cbegin(), na.cend());
-    std::vector<unsigned char> ck(ca.cbegin(), ca.cend());
-    std::vector<unsigned char> sk(sa.cbegin(), sa.cend());
-
-    std::vector<unsigned char> d;
-    d.resize(BrowserShared::NATIVEMSG_MAX_LENGTH);
 
-    if (m.empty() || n.empty() || ck.empty() || sk.empty()) {
+    if (ma.size() <= static_cast<int>(crypto_box_MACBYTES) || na.size() != static_cast<int>(crypto_box_NONCEBYTES)
+        || sharedKey.size() != crypto_box_BEFORENMBYTES) {
         return {};
     }
 
-    if (crypto_box_open_easy(d.data(), m.data(), ma.length(), n.data(), ck.data(), sk.data()) == 0) {
+    // One extra zero byte terminates the plaintext
+    std::vector<unsigned char> d(ma.size() - crypto_box_MACBYTES + 1);
+    if (crypto_box_open_easy_afternm(d.data(),
+                                     reinterpret_cast<const unsigned char*>(ma.constData()),
+                                     ma.size(),
+                                     reinterpret_cast<const unsigned char*>(na.constData()),
+                                     sharedKey.data())
+        == 0) {
         return getQByteArray(d.data(), std::char_traits<char>::length(reinterpret_cast<const char*>(d.data())));
     }
 
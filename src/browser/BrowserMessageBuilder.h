@@ -22,9 +22,12 @@
 #include <QString>
 #include <QVariant>
 
+#include <botan/secmem.h>
+
 class QJsonObject;
 
 typedef QMap<QString, QVariant> Parameters;
+typedef Botan::secure_vector<uint8_t> SharedKey;
 
 namespace
 {
@@ -71,6 +74,8 @@ public:
                               const Parameters& params,
                               const QString& publicKey,
                               const QString& secretKey);
+    QJsonObject
+    buildResponse(const QString& action, const QString& nonce, const Parameters& params, const SharedKey& sharedKey);
     QJsonObject getErrorReply(const QString& action, const int errorCode) const;
     QString getErrorMessage(const int errorCode) const;
 
@@ -84,6 +89,12 @@ public:
     QByteArray
     decrypt(const QString& encrypted, const QString& nonce, const QString& publicKey, const QString& secretKey);
 
+    SharedKey getSharedKey(const QString& publicKey, const QString& secretKey);
+    QString encryptMessage(const QJsonObject& message, const QString& nonce, const SharedKey& sharedKey);
+    QJsonObject decryptMessage(const QString& message, const QString& nonce, const SharedKey& sharedKey);
+    QString encrypt(const QString& plaintext, const QString& nonce, const SharedKey& sharedKey);
+    QByteArray decrypt(const QString& encrypted, const QString& nonce, const SharedKey& sharedKey);
+
     QString getBase64FromKey(const uchar* array, const uint len);
     QByteArray getQByteArray(const uchar* array, const uint len) const;
     QJsonObject getJsonObject(const uchar* pArray, const uint len) const;
@@ -949,40 +949,57 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
         return entries;
     }
 
-    for (const auto& group : rootGroup->groupsRecursive(true)) {
-        if (group->isRecycled()
-            || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable) {
-            continue;
+    auto isGroupHidden = [](const Group* group) {
+        return group->isRecycled()
+               || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable;
+    };
+
+    auto addEntry = [&](Entry* entry, const Group* group) {
+        if (entry->isRecycled()
+            || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
+                && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
+            return;
         }
 
         const auto omitWwwSubdomain =
             group->resolveCustomDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
-
-        for (auto* entry : group->entries()) {
-            if (entry->isRecycled()
-                || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
-                    && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
-                continue;
-            }
-
-            if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, omitWwwSubdomain)) {
-                continue;
-            }
+        if (!passkey && !shouldIncludeEntry(entry, siteUrl, formUrl, omitWwwSubdomain)) {
+            return;
+        }
 
 #ifdef WITH_XC_BROWSER_PASSKEYS
-            // With Passkeys, check for the Relying Party instead of URL
-            if (passkey && entry->attributes()->value(BrowserPasskeys::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
-                continue;
-            }
+        // With Passkeys, check for the Relying Party instead of URL
+        if (passkey && entry->attributes()->value(BrowserPasskeys::KPEX_PASSKEY_RELYING_PARTY) != siteUrl) {
+            return;
+        }
 #endif
 
-            // Additional URL check may have already inserted the entry to the list
-            if (!entries.contains(entry)) {
-                entries.append(entry);
+        // Additional URL check may have already inserted the entry to the list
+        if (!entries.contains(entry)) {
+            entries.append(entry);
+        }
+    };
+
+    // Regular URLs can only match entries with a URL on the same domain, only check those
+    if (!passkey && !siteUrl.startsWith("keepassxc://") && !siteUrl.startsWith("file://")) {
+        for (auto* entry : db->findEntriesByHost(QUrl(siteUrl).host())) {
+            if (!isGroupHidden(entry->group())) {
+                addEntry(entry, entry->group());
             }
         }
+        return entries;
     }
 
+    rootGroup->forEachGroupRecursive([&](Group* group) {
+        if (isGroupHidden(group)) {
+            return;
+        }
+
+        for (auto* entry : group->entries()) {
+            addEntry(entry, group);
+        }
+    });
+
     return entries;
 }
 
@@ -1018,14 +1035,10 @@ QList<Entry*> BrowserService::searchEntries(const QString& siteUrl,
         }
     }
 
-    // Search entries matching the hostname
-    QString hostname = QUrl(siteUrl).host();
     QList<Entry*> entries;
-    do {
-        for (const auto& db : databases) {
-            entries << searchEntries(db, siteUrl, formUrl, passkey);
-        }
-    } while (entries.isEmpty() && removeFirstDomain(hostname));
+    for (const auto& db : databases) {
+        entries << searchEntries(db, siteUrl, formUrl, passkey);
+    }
 
     return entries;
 }
@@ -1262,23 +1275,6 @@ int BrowserService::sortPriority(const QStringList& urls, const QString& siteUrl
     return *std::max_element(priorityList.begin(), priorityList.end());
 }
 
-bool BrowserService::removeFirstDomain(QString& hostname)
-{
-    int pos = hostname.indexOf(".");
-    if (pos < 0) {
-        return false;
-    }
-
-    // Don't remove the second-level domain if it's the only one
-    if (hostname.count(".") > 1) {
-        hostname = hostname.mid(pos + 1);
-        return !hostname.isEmpty();
-    }
-
-    // Nothing removed
-    return false;
-}
-
 /* Test if a search URL matches a custom entry. If the URL has the schema "keepassxc", some special checks will be made.
  * Otherwise, this simply delegates to handleURL(). */
 bool BrowserService::shouldIncludeEntry(Entry* entry,
@@ -20,6 +20,7 @@
 #include "config-keepassx.h"
 
 #include <QDir>
+#include <QJsonDocument>
 #include <QStandardPaths>
 #if defined(KEEPASSXC_DIST_SNAP)
 #include <QProcessEnvironment>
@@ -57,4 +58,28 @@ namespace BrowserShared
         return QStandardPaths::writableLocation(QStandardPaths::TempLocation) + serverName;
 #endif
     }
+
+    /**
+     * Split data read from the local socket into single messages.
+     *
+     * Messages are JSON documents sent without framing, a single read can return
+     * several of them. Data that is not valid JSON is returned as one message.
+     */
+    QList<QByteArray> splitMessages(const QByteArray& data)
+    {
+        QList<QByteArray> messages;
+        int pos = 0;
+        while (pos < data.size()) {
+            QJsonParseError error;
+            QJsonDocument::fromJson(data.mid(pos), &error);
+            if (error.error != QJsonParseError::GarbageAtEnd || error.offset <= 0) {
+                messages.append(data.mid(pos));
+                break;
+            }
+            // The offset points past the first message and the whitespace following it
+            messages.append(data.mid(pos, error.offset));
+            pos += error.offset;
+        }
+        return messages;
+    }
 } // namespace BrowserShared
@@ -36,12 +36,19 @@ const QCommandLineOption Analyze::OkonOption =
                        QObject::tr("Path to okon-cli to search a formatted HIBP file"),
                        QObject::tr("okon-cli"));
 
+const QCommandLineOption Analyze::HIBPIndexOption =
+    QCommandLineOption("hibp-index",
+                       QObject::tr("Path of a binary index of the HIBP file, created on first use. "
+                                   "The HIBP file must be ordered by hash to build the index."),
+                       QObject::tr("FILENAME"));
+
 Analyze::Analyze()
 {
     name = QString("analyze");
     description = QObject::tr("Analyze passwords for weaknesses and problems.");
     options.append(Analyze::HIBPDatabaseOption);
     options.append(Analyze::OkonOption);
+    options.append(Analyze::HIBPIndexOption);
 }
 
 int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
@@ -67,15 +74,21 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
             return EXIT_FAILURE;
         }
     } else {
-        QFile hibpFile(hibpDatabase);
-        if (!hibpFile.open(QFile::ReadOnly)) {
-            err << QObject::tr("Failed to open HIBP file %1: %2").arg(hibpDatabase).arg(hibpFile.errorString()) << endl;
-            return EXIT_FAILURE;
+        auto hibpIndex = parser->value(Analyze::HIBPIndexOption);
+        if (!hibpIndex.isEmpty()) {
+            if (!QFile::exists(hibpIndex)) {
+                out << QObject::tr("Building HIBP index, this will take a while…") << endl;
+                if (!HibpOffline::buildIndex(hibpDatabase, hibpIndex, &error)) {
+                    err << error << endl;
+                    return EXIT_FAILURE;
+                }
+            }
+            hibpDatabase = hibpIndex;
         }
 
         out << QObject::tr("Evaluating database entries against HIBP file, this will take a while…") << endl;
 
-        if (!HibpOffline::report(database, hibpFile, findings, &error)) {
+        if (!HibpOffline::report(database, hibpDatabase, findings, &error)) {
             err << error << endl;
             return EXIT_FAILURE;
         }
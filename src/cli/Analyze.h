@@ -28,6 +28,7 @@ public:
 
     static const QCommandLineOption HIBPDatabaseOption;
     static const QCommandLineOption OkonOption;
+    static const QCommandLineOption HIBPIndexOption;
 };
 
 #endif // KEEPASSXC_HIBP_H
@@ -113,7 +113,14 @@ int AutoTypeAssociations::associationsSize() const
 
 void AutoTypeAssociations::clear()
 {
+    if (m_associations.isEmpty()) {
+        return;
+    }
+
+    emit aboutToReset();
     m_associations.clear();
+    emit reset();
+    emitModified();
 }
 
 bool AutoTypeAssociations::operator==(const AutoTypeAssociations& other) const
@@ -62,6 +62,7 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
     {Config::AutoSaveNonDataChanges,{QS("AutoSaveNonDataChanges"), Roaming, true}},
     {Config::BackupBeforeSave,{QS("BackupBeforeSave"), Roaming, false}},
     {Config::BackupFilePathPattern,{QS("BackupFilePathPattern"), Roaming, QString("{DB_FILENAME}.old.kdbx")}},
+    {Config::BackupCount,{QS("BackupCount"), Roaming, 0}},
     {Config::UseAtomicSaves,{QS("UseAtomicSaves"), Roaming, true}},
     {Config::UseDirectWriteSaves,{QS("UseDirectWriteSaves"), Local, false}},
     {Config::SearchLimitGroup,{QS("SearchLimitGroup"), Roaming, false}},
@@ -223,14 +224,19 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
 
 QPointer<Config> Config::m_instance(nullptr);
 
+/**
+ * Get the current value of a setting.
+ *
+ * Values are served from an in-memory snapshot that is kept in sync with the
+ * settings files, so this is cheap enough to be called from paint and search code.
+ */
 QVariant Config::get(ConfigKey key)
 {
-    auto cfg = configStrings[key];
-    auto defaultValue = configStrings[key].defaultValue;
-    if (m_localSettings && cfg.type == Local) {
-        return m_localSettings->value(cfg.name, defaultValue);
+    auto snapshot = std::atomic_load(&m_snapshot);
+    if (!snapshot || key < 0 || key >= snapshot->size()) {
+        return readValue(key);
     }
-    return m_settings->value(cfg.name, defaultValue);
+    return snapshot->at(key);
 }
 
 QVariant Config::getDefault(Config::ConfigKey key)
@@ -261,6 +267,7 @@ void Config::set(ConfigKey key, const QVariant& value)
         m_settings->setValue(cfg.name, value);
     }
 
+    updateSnapshot(key, value);
     emit changed(key);
 }
 
@@ -273,6 +280,7 @@ void Config::remove(ConfigKey key)
         m_settings->remove(cfg.name);
     }
 
+    updateSnapshot(key, configStrings[key].defaultValue);
     emit changed(key);
 }
 
@@ -289,6 +297,8 @@ void Config::sync()
     if (m_localSettings) {
         m_localSettings->sync();
     }
+    // Syncing also picks up changes other instances wrote to the files
+    reloadSnapshot();
 }
 
 void Config::resetToDefaults()
@@ -297,6 +307,45 @@ void Config::resetToDefaults()
     if (m_localSettings) {
         m_localSettings->clear();
     }
+    reloadSnapshot();
+}
+
+/**
+ * Read a setting directly from the settings files.
+ */
+QVariant Config::readValue(ConfigKey key) const
+{
+    const auto cfg = configStrings.value(key);
+    if (m_localSettings && cfg.type == Local) {
+        return m_localSettings->value(cfg.name, cfg.defaultValue);
+    }
+    return m_settings->value(cfg.name, cfg.defaultValue);
+}
+
+/**
+ * Rebuild the value snapshot from the settings files.
+ */
+void Config::reloadSnapshot()
+{
+    auto snapshot = std::make_shared<QVector<QVariant>>(static_cast<int>(Deleted));
+    for (int key = 0; key < Deleted; ++key) {
+        (*snapshot)[key] = readValue(static_cast<ConfigKey>(key));
+    }
+    std::atomic_store(&m_snapshot, std::shared_ptr<const QVector<QVariant>>(std::move(snapshot)));
+}
+
+/**
+ * Publish a new snapshot with a single value replaced.
+ */
+void Config::updateSnapshot(ConfigKey key, const QVariant& value)
+{
+    auto current = std::atomic_load(&m_snapshot);
+    if (!current || key < 0 || key >= current->size()) {
+        return;
+    }
+    auto snapshot = std::make_shared<QVector<QVariant>>(*current);
+    (*snapshot)[key] = value;
+    std::atomic_store(&m_snapshot, std::shared_ptr<const QVector<QVariant>>(std::move(snapshot)));
 }
 
 /**
@@ -499,7 +548,9 @@ void Config::init(const QString& configFileName, const QString& localConfigFileN
         m_localSettings.reset(new QSettings(localConfigFileName, QSettings::IniFormat));
     }
 
+    reloadSnapshot();
     migrate();
+    reloadSnapshot();
     connect(qApp, &QCoreApplication::aboutToQuit, this, &Config::sync);
 }
 
@@ -21,6 +21,9 @@
 
 #include <QPointer>
 #include <QVariant>
+#include <QVector>
+
+#include <memory>
 
 class QSettings;
 
@@ -44,6 +47,7 @@ public:
         AutoSaveNonDataChanges,
         BackupBeforeSave,
         BackupFilePathPattern,
+        BackupCount,
         UseAtomicSaves,
         UseDirectWriteSaves,
         SearchLimitGroup,
@@ -219,6 +223,9 @@ private:
     explicit Config(QObject* parent);
     void init(const QString& configFileName, const QString& localConfigFileName);
     void migrate();
+    QVariant readValue(ConfigKey key) const;
+    void reloadSnapshot();
+    void updateSnapshot(ConfigKey key, const QVariant& value);
     static QPair<QString, QString> defaultConfigFiles();
 
     static QPointer<Config> m_instance;
@@ -226,6 +233,9 @@ private:
     QScopedPointer<QSettings> m_settings;
     QScopedPointer<QSettings> m_localSettings;
     QHash<QString, QVariant> m_defaults;
+    // Current value of every key, indexed by ConfigKey. Snapshots are never modified
+    // once published, writers swap in a new one so readers do not need a lock.
+    std::shared_ptr<const QVector<QVariant>> m_snapshot;
 };
 
 inline Config* config()
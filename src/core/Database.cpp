@@ -19,6 +19,7 @@
 #include "Database.h"
 
 #include "core/AsyncTask.h"
+#include "core/FileCopy.h"
 #include "core/FileWatcher.h"
 #include "core/Group.h"
 #include "format/KdbxXmlReader.h"
@@ -27,10 +28,12 @@
 
 #include <QFileInfo>
 #include <QJsonObject>
+#include <QRandomGenerator>
 #include <QRegularExpression>
 #include <QSaveFile>
 #include <QTemporaryFile>
 #include <QTimer>
+#include <QUrl>
 
 QHash<QUuid, QPointer<Database>> Database::s_uuidMap;
 
@@ -39,6 +42,7 @@ Database::Database()
     , m_data()
     , m_rootGroup(nullptr)
     , m_fileWatcher(new FileWatcher(this))
+    , m_referenceIndexSeed(QRandomGenerator::system()->generate())
     , m_uuid(QUuid::createUuid())
 {
     // setup modified timer
@@ -83,6 +87,9 @@ Database::Database(const QString& filePath)
 Database::~Database()
 {
     releaseData();
+    // The empty root group left by releaseData() removes itself from the lookup indexes,
+    // delete it while they still exist instead of leaving it to ~QObject()
+    delete m_rootGroup;
 }
 
 QUuid Database::uuid() const
@@ -275,10 +282,23 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
     QFileInfo fileInfo(filePath);
     auto realFilePath = fileInfo.exists() ? fileInfo.canonicalFilePath() : fileInfo.absoluteFilePath();
     bool isNewFile = !QFile::exists(realFilePath);
-    bool ok = AsyncTask::runAndWaitForFuture([&] { return performSave(realFilePath, action, backupFilePath, error); });
+
+    // Write a snapshot so the database can still be modified while the save is running
+    auto snapshot = createSaveSnapshot();
+    auto kdf = m_data.kdf;
+    auto modificationCount = m_modificationCount;
+    bool ok = AsyncTask::runAndWaitForFuture(
+        [&] { return snapshot->performSave(realFilePath, action, backupFilePath, error); });
     if (ok) {
+        takeSavedKeyState(snapshot.data(), kdf);
         setFilePath(filePath);
-        markAsClean();
+        if (modificationCount == m_modificationCount) {
+            markAsClean();
+        } else {
+            // Changes made during the save are not part of the file, keep them for the next save
+            emit databaseSaved();
+            markAsModified();
+        }
         if (isNewFile) {
             QFile::setPermissions(realFilePath, QFile::ReadUser | QFile::WriteUser);
         }
@@ -291,6 +311,122 @@ bool Database::saveAs(const QString& filePath, SaveAction action, const QString&
     return ok;
 }
 
+namespace
+{
+    /**
+     * Clone a group tree for a save snapshot.
+     *
+     * Group::clone() attaches the cloned entries and children with time info updates
+     * enabled, which stamps LocationChanged with the current time on every object.
+     * The snapshot must keep the times of the originals, so attach them without.
+     */
+    Group* cloneForSnapshot(const Group* group)
+    {
+        auto clonedGroup = group->clone(Entry::CloneIncludeHistory, Group::CloneNoFlags);
+
+        for (const Entry* entry : group->entries()) {
+            auto clonedEntry = entry->clone(Entry::CloneIncludeHistory);
+            clonedEntry->setUpdateTimeinfo(false);
+            clonedEntry->setGroup(clonedGroup);
+            clonedEntry->setUpdateTimeinfo(true);
+        }
+
+        for (const Group* child : group->children()) {
+            auto clonedChild = cloneForSnapshot(child);
+            clonedChild->setUpdateTimeinfo(false);
+            clonedChild->setParent(clonedGroup);
+            clonedChild->setUpdateTimeinfo(true);
+        }
+
+        return clonedGroup;
+    }
+} // namespace
+
+/**
+ * Create a detached copy of the database that can be written on a worker thread.
+ *
+ * This runs on the GUI thread and is a deep copy of the object tree: every group, entry
+ * and history item is cloned together with its attribute, attachment, auto-type and
+ * custom data objects. Only the string and attachment payloads inside them are
+ * implicitly shared with the originals. The cost grows with the number of entries and
+ * history items, TestDatabase::benchmarkSaveSnapshot compares it to writing the file.
+ */
+QSharedPointer<Database> Database::createSaveSnapshot()
+{
+    auto snapshot = QSharedPointer<Database>::create();
+    snapshot->setEmitModified(false);
+
+    snapshot->m_data.formatVersion = m_data.formatVersion;
+    snapshot->m_data.filePath = m_data.filePath;
+    snapshot->m_data.cipher = m_data.cipher;
+    snapshot->m_data.compressionAlgorithm = m_data.compressionAlgorithm;
+    snapshot->m_data.masterSeed->setRawKey(m_data.masterSeed->rawKey());
+    snapshot->m_data.transformedDatabaseKey->setRawKey(m_data.transformedDatabaseKey->rawKey());
+    snapshot->m_data.challengeResponseKey->setRawKey(m_data.challengeResponseKey->rawKey());
+    snapshot->m_data.key = m_data.key;
+    // The writer re-randomizes the transform seed, it must not touch our KDF
+    snapshot->m_data.kdf = m_data.kdf ? m_data.kdf->clone() : QSharedPointer<Kdf>();
+    snapshot->m_data.publicCustomData = m_data.publicCustomData;
+    snapshot->m_deletedObjects = m_deletedObjects;
+
+    // Hand over the key derived in the background, the snapshot consumes it
+    snapshot->m_preparedKeyTransformation = m_preparedKeyTransformation;
+    m_preparedKeyTransformation = {};
+
+    // The cloned tree is not attached through setRootGroup(), writing it does not need
+    // the lookup indexes and building them would defeat the purpose of the snapshot
+    auto rootGroup = cloneForSnapshot(m_rootGroup);
+    delete snapshot->m_rootGroup;
+    snapshot->m_rootGroup = rootGroup;
+    rootGroup->QObject::setParent(snapshot.data());
+
+    // Groups reference their last top visible entry by pointer, resolve it in the clone
+    const auto groups = m_rootGroup->groupsRecursive(true);
+    const auto clonedGroups = rootGroup->groupsRecursive(true);
+    Q_ASSERT(groups.size() == clonedGroups.size());
+    QHash<QUuid, Entry*> clonedEntries;
+    for (int i = 0; i < groups.size(); ++i) {
+        auto entry = groups[i]->lastTopVisibleEntry();
+        if (!entry) {
+            continue;
+        }
+        if (clonedEntries.isEmpty()) {
+            for (auto clonedEntry : rootGroup->entriesRecursive(false)) {
+                clonedEntries.insert(clonedEntry->uuid(), clonedEntry);
+            }
+        }
+        clonedGroups[i]->setLastTopVisibleEntry(clonedEntries.value(entry->uuid()));
+    }
+
+    snapshot->m_metadata->copyFrom(m_metadata, rootGroup);
+
+    return snapshot;
+}
+
+/**
+ * Take over the key material a successful save of the snapshot produced.
+ *
+ * Writing re-randomizes the transform seed and may upgrade the KDF together with the
+ * format version. If the key or KDF were changed while saving, the new settings are
+ * kept and the database stays modified instead.
+ *
+ * @param snapshot saved snapshot created by createSaveSnapshot()
+ * @param kdf KDF of this database at the time the snapshot was created
+ */
+void Database::takeSavedKeyState(const Database* snapshot, const QSharedPointer<Kdf>& kdf)
+{
+    if (m_data.key != snapshot->m_data.key || m_data.kdf != kdf) {
+        markAsModified();
+        return;
+    }
+
+    m_data.formatVersion = snapshot->m_data.formatVersion;
+    m_data.masterSeed->setRawKey(snapshot->m_data.masterSeed->rawKey());
+    m_data.transformedDatabaseKey->setRawKey(snapshot->m_data.transformedDatabaseKey->rawKey());
+    m_data.challengeResponseKey->setRawKey(snapshot->m_data.challengeResponseKey->rawKey());
+    m_data.kdf = snapshot->m_data.kdf;
+}
+
 bool Database::performSave(const QString& filePath, SaveAction action, const QString& backupFilePath, QString* error)
 {
     if (!backupFilePath.isNull()) {
@@ -479,6 +615,7 @@ void Database::releaseData()
     m_uuid = QUuid();
 
     m_data.clear();
+    m_preparedKeyTransformation = {};
     m_metadata->clear();
 
     auto oldGroup = rootGroup();
@@ -495,7 +632,8 @@ void Database::releaseData()
 
 /**
  * Remove the old backup and replace it with a new one. Backup name is taken from destinationFilePath.
- * Non-existing parent directories will be created automatically.
+ * Non-existing parent directories will be created automatically. Where the file system supports it,
+ * the backup shares its data blocks with the database or is copied inside the kernel.
  *
  * @param filePath Path to the file to backup
  * @param destinationFilePath Path to the backup destination file
@@ -512,7 +650,7 @@ bool Database::backupDatabase(const QString& filePath, const QString& destinatio
     }
     auto perms = QFile::permissions(filePath);
     QFile::remove(destinationFilePath);
-    bool res = QFile::copy(filePath, destinationFilePath);
+    bool res = FileCopy::copy(filePath, destinationFilePath);
     QFile::setPermissions(destinationFilePath, perms);
     return res;
 }
@@ -531,7 +669,7 @@ bool Database::restoreDatabase(const QString& filePath, const QString& fromBacku
     // Only try to restore if the backup file actually exists
     if (QFile::exists(fromBackupFilePath)) {
         QFile::remove(filePath);
-        if (QFile::copy(fromBackupFilePath, filePath)) {
+        if (FileCopy::copy(fromBackupFilePath, filePath)) {
             return QFile::setPermissions(filePath, perms);
         }
     }
@@ -802,11 +940,6 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
         return true;
     }
 
-    if (updateTransformSalt) {
-        m_data.kdf->randomizeSeed();
-        Q_ASSERT(!m_data.kdf->seed().isEmpty());
-    }
-
     PasswordKey oldTransformedDatabaseKey;
     if (m_data.key && !m_data.key->isEmpty()) {
         oldTransformedDatabaseKey.setRawKey(m_data.transformedDatabaseKey->rawKey());
@@ -814,7 +947,16 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
 
     QByteArray transformedDatabaseKey;
 
-    if (!transformKey) {
+    // Use the key derived in the background for a fresh seed if it matches
+    bool prepared = updateTransformSalt && transformKey && takePreparedKeyTransformation(key, transformedDatabaseKey);
+    if (updateTransformSalt && !prepared) {
+        m_data.kdf->randomizeSeed();
+        Q_ASSERT(!m_data.kdf->seed().isEmpty());
+    }
+
+    if (prepared) {
+        Q_ASSERT(!transformedDatabaseKey.isEmpty());
+    } else if (!transformKey) {
         transformedDatabaseKey = QByteArray(oldTransformedDatabaseKey.rawKey());
     } else if (!key->transform(*m_data.kdf, transformedDatabaseKey, &m_keyError)) {
         return false;
@@ -840,6 +982,72 @@ QString Database::keyError()
     return m_keyError;
 }
 
+/**
+ * Start deriving the transformed key for a freshly randomized KDF seed in the background.
+ *
+ * Every save re-randomizes the transform seed, so the next call to setKey() that updates
+ * the transform salt for the same key and KDF settings picks up this result instead of
+ * running the KDF on the save path. It only blocks if the derivation has not finished yet.
+ * Keys with challenge-response components are never pre-derived since that would require
+ * user interaction with the hardware key.
+ */
+void Database::prepareNextKeyTransformation()
+{
+    m_preparedKeyTransformation = {};
+
+    auto key = m_data.key;
+    if (!key || key->isEmpty() || !key->challengeResponseKeys().isEmpty() || !m_data.kdf) {
+        return;
+    }
+
+    auto kdf = m_data.kdf->clone();
+    kdf->randomizeSeed();
+
+    m_preparedKeyTransformation.key = key;
+    m_preparedKeyTransformation.kdf = kdf;
+    m_preparedKeyTransformation.transformedKey = QtConcurrent::run([key, kdf] {
+        QByteArray transformedKey;
+        if (!key->transform(*kdf, transformedKey)) {
+            transformedKey.clear();
+        }
+        return transformedKey;
+    });
+}
+
+/**
+ * Consume the key prepared by prepareNextKeyTransformation().
+ *
+ * On success the transform seed of the database KDF is replaced by the prepared seed.
+ *
+ * @param key composite key about to be set
+ * @param transformedKey receives the prepared transformed key
+ * @return true if a prepared key for this composite key and the current KDF settings was available
+ */
+bool Database::takePreparedKeyTransformation(const QSharedPointer<const CompositeKey>& key, QByteArray& transformedKey)
+{
+    auto prepared = m_preparedKeyTransformation;
+    m_preparedKeyTransformation = {};
+
+    if (!prepared.kdf || prepared.key != key || !m_data.kdf || prepared.kdf->uuid() != m_data.kdf->uuid()) {
+        return false;
+    }
+
+    // Discard the result if the KDF settings changed since the derivation started
+    auto currentKdf = m_data.kdf->clone();
+    currentKdf->setSeed(prepared.kdf->seed());
+    if (currentKdf->writeParameters() != prepared.kdf->writeParameters()) {
+        return false;
+    }
+
+    transformedKey = prepared.transformedKey.result();
+    if (transformedKey.isEmpty()) {
+        return false;
+    }
+
+    m_data.kdf->setSeed(prepared.kdf->seed());
+    return true;
+}
+
 QVariantMap& Database::publicCustomData()
 {
     return m_data.publicCustomData;
@@ -921,6 +1129,7 @@ bool Database::hasNonDataChanges() const
 void Database::markAsModified()
 {
     m_modified = true;
+    ++m_modificationCount;
     if (modifiedSignalEnabled() && !m_modifiedTimer.isActive()) {
         // Small time delay prevents numerous consecutive saves due to repeated signals
         startModifiedTimer();
@@ -944,6 +1153,429 @@ void Database::markNonDataChange()
     emit databaseNonDataChanged();
 }
 
+namespace
+{
+    bool isWithinGroup(const Group* group, const Group* scope)
+    {
+        for (; group; group = group->parentGroup()) {
+            if (group == scope) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const QList<EntryReferenceType> IndexedReferenceTypes{EntryReferenceType::Title,
+                                                          EntryReferenceType::UserName,
+                                                          EntryReferenceType::Password,
+                                                          EntryReferenceType::Url,
+                                                          EntryReferenceType::Notes};
+
+    QString referenceFieldValue(const Entry* entry, EntryReferenceType referenceType)
+    {
+        switch (referenceType) {
+        case EntryReferenceType::Title:
+            return entry->title();
+        case EntryReferenceType::UserName:
+            return entry->username();
+        case EntryReferenceType::Password:
+            return entry->password();
+        case EntryReferenceType::Url:
+            return entry->url();
+        case EntryReferenceType::Notes:
+            return entry->notes();
+        default:
+            return {};
+        }
+    }
+
+    // Position of an entry in the order Group::findEntryBySearchTerm() visits entries:
+    // groups depth-first, the entries of a group before the entries of its subgroups
+    QVector<int> treePosition(const Entry* entry)
+    {
+        const Group* group = entry->group();
+        QVector<int> position{-1, group->entries().indexOf(const_cast<Entry*>(entry))};
+        for (; group->parentGroup(); group = group->parentGroup()) {
+            position.prepend(group->parentGroup()->children().indexOf(const_cast<Group*>(group)));
+        }
+        return position;
+    }
+
+    // Index key of entries with URLs that contain placeholders, these have to be checked on every lookup
+    const QString UnresolvedUrlKey = QStringLiteral("{}");
+
+    /**
+     * Last two labels of a host name, e.g. login.example.co.uk -> co.uk
+     *
+     * Two hosts sharing the same base domain always share this key as well,
+     * so it can be computed without consulting the public suffix list.
+     */
+    QString hostIndexKey(const QString& host)
+    {
+        const int lastDot = host.lastIndexOf('.');
+        if (lastDot <= 0) {
+            return host;
+        }
+        return host.mid(host.lastIndexOf('.', lastDot - 1) + 1);
+    }
+
+    QStringList urlIndexKeys(const Entry* entry)
+    {
+        QStringList urls{entry->url()};
+        const auto attributes = entry->attributes();
+        const auto passkeyRelyingParty = QString("%1_RELYING_PARTY").arg(EntryAttributes::PasskeyAttribute);
+        for (const auto& key : attributes->keys()) {
+            if (key.startsWith(EntryAttributes::AdditionalUrlAttribute) || key == passkeyRelyingParty) {
+                urls << attributes->value(key);
+            }
+        }
+
+        QStringList keys;
+        for (const auto& url : asConst(urls)) {
+            if (url.isEmpty()) {
+                continue;
+            }
+            if (url.contains('{')) {
+                keys << UnresolvedUrlKey;
+                continue;
+            }
+
+            const auto host = (url.contains("://") ? QUrl(url) : QUrl::fromUserInput(url)).host();
+            if (host.isEmpty()) {
+                continue;
+            }
+            keys << hostIndexKey(host);
+            // Groups can be configured to ignore the www subdomain of their entries
+            if (host.contains("www.")) {
+                keys << hostIndexKey(QString(host).remove("www."));
+            }
+        }
+
+        keys.removeDuplicates();
+        return keys;
+    }
+
+    // Index key of entries that have to be checked against every window title
+    const QString UnfilteredAutoTypeKey = QStringLiteral("{}");
+    const int AutoTypeKeyLength = 3;
+
+    /**
+     * Index key for a piece of text a matching window title must contain.
+     * Prefers a run of letters and digits over separators like " - " that many titles share.
+     */
+    QString autoTypeIndexKey(const QString& literal)
+    {
+        const QString folded = literal.toCaseFolded();
+        if (folded.size() < AutoTypeKeyLength) {
+            return UnfilteredAutoTypeKey;
+        }
+
+        for (int i = 0; i <= folded.size() - AutoTypeKeyLength; ++i) {
+            const QStringRef key = folded.midRef(i, AutoTypeKeyLength);
+            if (std::all_of(key.begin(), key.end(), [](QChar c) { return c.isLetterOrNumber(); })) {
+                return key.toString();
+            }
+        }
+        return folded.left(AutoTypeKeyLength);
+    }
+
+    QStringList autoTypeIndexKeys(const Entry* entry)
+    {
+        QStringList keys;
+
+        // Window associations are exact wildcard matches, the longest part between wildcards has to appear
+        const auto associations = entry->autoTypeAssociations()->getAll();
+        for (const auto& assoc : associations) {
+            const QString& window = assoc.window;
+            if (window.isEmpty()) {
+                continue;
+            }
+            if (window.contains('{') || (window.startsWith("//") && window.endsWith("//") && window.size() >= 4)) {
+                keys << UnfilteredAutoTypeKey;
+                continue;
+            }
+
+            QString longest;
+            for (const auto& part : window.split('*')) {
+                if (part.size() > longest.size()) {
+                    longest = part;
+                }
+            }
+            keys << autoTypeIndexKey(longest);
+        }
+
+        // The title and URL are looked for inside the window title
+        const QString title = entry->title();
+        if (title.contains('{')) {
+            keys << UnfilteredAutoTypeKey;
+        } else if (!title.isEmpty()) {
+            keys << autoTypeIndexKey(title);
+        }
+
+        const QString url = entry->url();
+        if (url.contains('{')) {
+            keys << UnfilteredAutoTypeKey;
+        } else if (!url.isEmpty()) {
+            keys << autoTypeIndexKey(url);
+            const QString host = QUrl(url).host();
+            if (!host.isEmpty()) {
+                keys << autoTypeIndexKey(host);
+            }
+        }
+
+        keys.removeDuplicates();
+        return keys;
+    }
+} // namespace
+
+void Database::addToUuidIndex(Group* group)
+{
+    if (!group->uuid().isNull()) {
+        m_groupIndex.insert(group->uuid(), group);
+    }
+}
+
+void Database::removeFromUuidIndex(Group* group, const QUuid& uuid)
+{
+    m_groupIndex.remove(uuid, group);
+}
+
+void Database::addToUuidIndex(Entry* entry)
+{
+    if (!entry->uuid().isNull()) {
+        m_entryIndex.insert(entry->uuid(), entry);
+    }
+}
+
+void Database::removeFromUuidIndex(Entry* entry, const QUuid& uuid)
+{
+    m_entryIndex.remove(uuid, entry);
+}
+
+/**
+ * Look up an entry of this database by UUID.
+ *
+ * @param uuid entry UUID
+ * @param scope group the entry has to belong to
+ * @param recursive also accept entries from subgroups of scope
+ * @return matching entry or nullptr
+ */
+Entry* Database::findIndexedEntry(const QUuid& uuid, const Group* scope, bool recursive) const
+{
+    for (auto it = m_entryIndex.constFind(uuid); it != m_entryIndex.cend() && it.key() == uuid; ++it) {
+        const Group* group = it.value()->group();
+        if (recursive ? isWithinGroup(group, scope) : group == scope) {
+            return it.value();
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Look up a group of this database by UUID.
+ *
+ * @param uuid group UUID
+ * @param scope the group itself or one of its ancestors
+ * @return matching group or nullptr
+ */
+Group* Database::findIndexedGroup(const QUuid& uuid, const Group* scope) const
+{
+    for (auto it = m_groupIndex.constFind(uuid); it != m_groupIndex.cend() && it.key() == uuid; ++it) {
+        if (isWithinGroup(it.value(), scope)) {
+            return it.value();
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Add an entry to the reference index or refresh its indexed field values.
+ */
+void Database::addToReferenceIndex(Entry* entry)
+{
+    removeFromReferenceIndex(entry);
+
+    QVector<uint> hashes;
+    hashes.reserve(IndexedReferenceTypes.size());
+    for (EntryReferenceType referenceType : IndexedReferenceTypes) {
+        const uint hash = qHash(referenceFieldValue(entry, referenceType), m_referenceIndexSeed);
+        m_referenceIndex.insert(qMakePair(static_cast<int>(referenceType), hash), entry);
+        hashes << hash;
+    }
+    m_referenceHashes.insert(entry, hashes);
+}
+
+void Database::removeFromReferenceIndex(Entry* entry)
+{
+    const QVector<uint> hashes = m_referenceHashes.take(entry);
+    for (int i = 0; i < hashes.size(); ++i) {
+        m_referenceIndex.remove(qMakePair(static_cast<int>(IndexedReferenceTypes[i]), hashes[i]), entry);
+    }
+}
+
+/**
+ * Find the entry a field reference points to.
+ *
+ * If several entries match, the one found first by a depth-first walk of scope is returned.
+ *
+ * @param term value the field has to be equal to
+ * @param referenceType a standard field
+ * @param scope group the entry has to be part of
+ * @return matching entry or nullptr
+ */
+Entry* Database::findReferencedEntry(const QString& term, EntryReferenceType referenceType, const Group* scope) const
+{
+    Entry* result = nullptr;
+    QVector<int> resultPosition;
+
+    const auto key = qMakePair(static_cast<int>(referenceType), qHash(term, m_referenceIndexSeed));
+    for (auto it = m_referenceIndex.constFind(key); it != m_referenceIndex.cend() && it.key() == key; ++it) {
+        Entry* entry = it.value();
+        // The index only narrows down the candidates, different values can share a hash
+        if (!isWithinGroup(entry->group(), scope) || referenceFieldValue(entry, referenceType) != term) {
+            continue;
+        }
+        if (!result) {
+            result = entry;
+            continue;
+        }
+        if (resultPosition.isEmpty()) {
+            resultPosition = treePosition(result);
+        }
+        const QVector<int> position = treePosition(entry);
+        if (position < resultPosition) {
+            result = entry;
+            resultPosition = position;
+        }
+    }
+    return result;
+}
+
+/**
+ * Add an entry to the URL index or refresh its indexed hosts.
+ */
+void Database::addToUrlIndex(Entry* entry)
+{
+    removeFromUrlIndex(entry);
+
+    const QStringList keys = urlIndexKeys(entry);
+    for (const auto& key : keys) {
+        m_urlIndex.insert(key, entry);
+    }
+    if (!keys.isEmpty()) {
+        m_urlIndexKeys.insert(entry, keys);
+    }
+}
+
+void Database::removeFromUrlIndex(Entry* entry)
+{
+    const QStringList keys = m_urlIndexKeys.take(entry);
+    for (const auto& key : keys) {
+        m_urlIndex.remove(key, entry);
+    }
+}
+
+/**
+ * Find the entries that may have a URL matching the given host.
+ *
+ * The result is a superset of the entries with a URL on the same base domain, the URLs
+ * still have to be compared by the caller. Entries are returned in tree order.
+ *
+ * @param host host name of the site
+ * @return candidate entries, including recycled ones
+ */
+QList<Entry*> Database::findEntriesByHost(const QString& host) const
+{
+    QList<Entry*> entries = m_urlIndex.values(hostIndexKey(host));
+    for (auto* entry : m_urlIndex.values(UnresolvedUrlKey)) {
+        if (!entries.contains(entry)) {
+            entries << entry;
+        }
+    }
+
+    if (entries.size() > 1) {
+        QVector<QPair<QVector<int>, Entry*>> positions;
+        positions.reserve(entries.size());
+        for (auto* entry : asConst(entries)) {
+            positions.append({treePosition(entry), entry});
+        }
+        std::sort(positions.begin(), positions.end());
+        for (int i = 0; i < positions.size(); ++i) {
+            entries[i] = positions[i].second;
+        }
+    }
+
+    return entries;
+}
+
+/**
+ * Add an entry to the Auto-Type index or refresh its indexed window title fragments.
+ */
+void Database::addToAutoTypeIndex(Entry* entry)
+{
+    removeFromAutoTypeIndex(entry);
+
+    const QStringList keys = autoTypeIndexKeys(entry);
+    for (const auto& key : keys) {
+        m_autoTypeIndex.insert(key, entry);
+    }
+    if (!keys.isEmpty()) {
+        m_autoTypeIndexKeys.insert(entry, keys);
+    }
+}
+
+void Database::removeFromAutoTypeIndex(Entry* entry)
+{
+    const QStringList keys = m_autoTypeIndexKeys.take(entry);
+    for (const auto& key : keys) {
+        m_autoTypeIndex.remove(key, entry);
+    }
+}
+
+/**
+ * Find the entries that may have Auto-Type sequences for the given window.
+ *
+ * The result is a superset of the entries whose window associations, title or URL match,
+ * Entry::autoTypeSequences() still has to be called on each of them. Entries without any
+ * of these never match and are left out. Entries are returned in tree order.
+ *
+ * @param windowTitle title of the target window
+ * @return candidate entries, including recycled and disabled ones
+ */
+QList<Entry*> Database::findAutoTypeCandidates(const QString& windowTitle) const
+{
+    QSet<Entry*> candidates;
+    for (auto* entry : m_autoTypeIndex.values(UnfilteredAutoTypeKey)) {
+        candidates.insert(entry);
+    }
+
+    // Only entries with a key occurring somewhere in the window title can match
+    const QString folded = windowTitle.toCaseFolded();
+    QSet<QString> titleKeys;
+    for (int i = 0; i <= folded.size() - AutoTypeKeyLength; ++i) {
+        titleKeys.insert(folded.mid(i, AutoTypeKeyLength));
+    }
+    for (const auto& key : asConst(titleKeys)) {
+        for (auto* entry : m_autoTypeIndex.values(key)) {
+            candidates.insert(entry);
+        }
+    }
+
+    QVector<QPair<QVector<int>, Entry*>> positions;
+    positions.reserve(candidates.size());
+    for (auto* entry : asConst(candidates)) {
+        positions.append({treePosition(entry), entry});
+    }
+    std::sort(positions.begin(), positions.end());
+
+    QList<Entry*> entries;
+    entries.reserve(positions.size());
+    for (const auto& position : asConst(positions)) {
+        entries << position.second;
+    }
+    return entries;
+}
+
 /**
  * @param uuid UUID of the database
  * @return pointer to the database or nullptr if no such database exists
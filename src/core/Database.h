@@ -20,6 +20,7 @@
 #define KEEPASSX_DATABASE_H
 
 #include <QDateTime>
+#include <QFuture>
 #include <QHash>
 #include <QMutex>
 #include <QPointer>
@@ -79,6 +80,8 @@ private:
     bool backupDatabase(const QString& filePath, const QString& destinationFilePath);
     bool restoreDatabase(const QString& filePath, const QString& fromBackupFilePath);
     bool performSave(const QString& filePath, SaveAction flags, const QString& backupFilePath, QString* error);
+    QSharedPointer<Database> createSaveSnapshot();
+    void takeSavedKeyState(const Database* snapshot, const QSharedPointer<Kdf>& kdf);
 
 public:
     bool open(QSharedPointer<const CompositeKey> key, QString* error = nullptr);
@@ -138,6 +141,7 @@ public:
                 bool updateTransformSalt = false,
                 bool transformKey = true);
     QString keyError();
+    void prepareNextKeyTransformation();
     QByteArray challengeResponseKey() const;
     bool challengeMasterSeed(const QByteArray& masterSeed);
     const QUuid& cipher() const;
@@ -150,6 +154,9 @@ public:
     bool changeKdf(const QSharedPointer<Kdf>& kdf);
     QByteArray transformedDatabaseKey() const;
 
+    QList<Entry*> findEntriesByHost(const QString& host) const;
+    QList<Entry*> findAutoTypeCandidates(const QString& windowTitle) const;
+
     static Database* databaseByUuid(const QUuid& uuid);
 
 public slots:
@@ -215,8 +222,30 @@ private:
         }
     };
 
+    struct PreparedKeyTransformation
+    {
+        QSharedPointer<const CompositeKey> key;
+        QSharedPointer<Kdf> kdf;
+        QFuture<QByteArray> transformedKey;
+    };
+
+    bool takePreparedKeyTransformation(const QSharedPointer<const CompositeKey>& key, QByteArray& transformedKey);
     void createRecycleBin();
 
+    void addToUuidIndex(Group* group);
+    void removeFromUuidIndex(Group* group, const QUuid& uuid);
+    void addToUuidIndex(Entry* entry);
+    void removeFromUuidIndex(Entry* entry, const QUuid& uuid);
+    Entry* findIndexedEntry(const QUuid& uuid, const Group* scope, bool recursive) const;
+    Group* findIndexedGroup(const QUuid& uuid, const Group* scope) const;
+    void addToReferenceIndex(Entry* entry);
+    void removeFromReferenceIndex(Entry* entry);
+    Entry* findReferencedEntry(const QString& term, EntryReferenceType referenceType, const Group* scope) const;
+    void addToUrlIndex(Entry* entry);
+    void removeFromUrlIndex(Entry* entry);
+    void addToAutoTypeIndex(Entry* entry);
+    void removeFromAutoTypeIndex(Entry* entry);
+
     void startModifiedTimer();
     void stopModifiedTimer();
 
@@ -228,14 +257,36 @@ private:
     QMutex m_saveMutex;
     QPointer<FileWatcher> m_fileWatcher;
     bool m_modified = false;
+    // Incremented by markAsModified(), tells whether changes were made while saving
+    quint64 m_modificationCount = 0;
     bool m_hasNonDataChange = false;
     QString m_keyError;
+    PreparedKeyTransformation m_preparedKeyTransformation;
 
     QStringList m_commonUsernames;
     QStringList m_tagList;
 
+    // Live UUID lookup tables for all groups and (non-history) entries attached to this database
+    QMultiHash<QUuid, Group*> m_groupIndex;
+    QMultiHash<QUuid, Entry*> m_entryIndex;
+    // Seeded hashes of the standard field values of the same entries, used to resolve {REF:...}
+    // placeholders. Field values are not kept here, passwords and notes would be copied otherwise.
+    QMultiHash<QPair<int, uint>, Entry*> m_referenceIndex;
+    QHash<const Entry*, QVector<uint>> m_referenceHashes;
+    uint m_referenceIndexSeed;
+    // Entries by the last two labels of the hosts of their URLs, used to look up browser logins
+    QMultiHash<QString, Entry*> m_urlIndex;
+    QHash<const Entry*, QStringList> m_urlIndexKeys;
+    // Entries by a short piece of text any window title they match must contain, used for global Auto-Type
+    QMultiHash<QString, Entry*> m_autoTypeIndex;
+    QHash<const Entry*, QStringList> m_autoTypeIndexKeys;
+
     QUuid m_uuid;
     static QHash<QUuid, QPointer<Database>> s_uuidMap;
+
+    friend class Entry;
+    friend class Group;
+    friend class TestDatabase;
 };
 
 #endif // KEEPASSX_DATABASE_H
@@ -32,6 +32,7 @@
 
 const int Entry::DefaultIconNumber = 0;
 const int Entry::ResolveMaximumDepth = 10;
+const int Entry::PlaceholderCacheMaximumSize = 32;
 const QString Entry::AutoTypeSequenceUsername = "{USERNAME}{ENTER}";
 const QString Entry::AutoTypeSequencePassword = "{PASSWORD}{ENTER}";
 
@@ -49,9 +50,15 @@ Entry::Entry()
     m_data.excludeFromReports = false;
 
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::updateTotp);
+    // Lookup indexes have to follow changes made while modified signals are blocked, e.g. during a merge
+    connect(m_attributes, &EntryAttributes::valuesChanged, this, &Entry::updateDatabaseIndexes);
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::modified);
     connect(m_attributes, &EntryAttributes::defaultKeyModified, this, &Entry::emitDataChanged);
     connect(m_attachments, &EntryAttachments::modified, this, &Entry::modified);
+    connect(m_autoTypeAssociations, &AutoTypeAssociations::reset, this, &Entry::updateAutoTypeIndex);
+    connect(m_autoTypeAssociations, &AutoTypeAssociations::added, this, &Entry::updateAutoTypeIndex);
+    connect(m_autoTypeAssociations, &AutoTypeAssociations::removed, this, &Entry::updateAutoTypeIndex);
+    connect(m_autoTypeAssociations, &AutoTypeAssociations::dataChanged, this, &Entry::updateAutoTypeIndex);
     connect(m_autoTypeAssociations, &AutoTypeAssociations::modified, this, &Entry::modified);
     connect(m_customData, &CustomData::modified, this, &Entry::modified);
 
@@ -223,7 +230,7 @@ QString Entry::defaultAutoTypeSequence() const
 const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 {
     if (!m_data.passwordHealth) {
-        m_data.passwordHealth.reset(new PasswordHealth(resolvePlaceholder(password())));
+        m_data.passwordHealth.reset(new PasswordHealth(PasswordHealth::cachedEntropy(resolvePlaceholder(password()))));
     }
     return m_data.passwordHealth;
 }
@@ -231,7 +238,7 @@ const QSharedPointer<PasswordHealth> Entry::passwordHealth()
 const QSharedPointer<PasswordHealth> Entry::passwordHealth() const
 {
     if (!m_data.passwordHealth) {
-        return QSharedPointer<PasswordHealth>::create(resolvePlaceholder(password()));
+        return QSharedPointer<PasswordHealth>::create(PasswordHealth::cachedEntropy(resolvePlaceholder(password())));
     }
     return m_data.passwordHealth;
 }
@@ -297,16 +304,26 @@ QList<QString> Entry::autoTypeSequences(const QString& windowTitle) const
 
     // Define helper functions to match window titles
     auto windowMatches = [&](const QString& pattern) {
-        // Regex searching
-        if (pattern.startsWith("//") && pattern.endsWith("//") && pattern.size() >= 4) {
-            QRegularExpression regExp(pattern.mid(2, pattern.size() - 4), QRegularExpression::CaseInsensitiveOption);
-            return regExp.match(windowTitle).hasMatch();
-        }
+        // Keep compiled patterns around, global Auto-Type runs this for many entries on every hotkey press
+        if (!m_windowRegexCache.contains(pattern)) {
+            if (m_windowRegexCache.size() >= PlaceholderCacheMaximumSize) {
+                m_windowRegexCache.clear();
+            }
 
-        // Wildcard searching
-        const auto regExp = Tools::convertToRegex(
-            pattern, Tools::RegexConvertOpts::EXACT_MATCH | Tools::RegexConvertOpts::WILDCARD_UNLIMITED_MATCH);
-        return regExp.match(windowTitle).hasMatch();
+            if (pattern.startsWith("//") && pattern.endsWith("//") && pattern.size() >= 4) {
+                // Regex searching
+                m_windowRegexCache.insert(
+                    pattern,
+                    QRegularExpression(pattern.mid(2, pattern.size() - 4), QRegularExpression::CaseInsensitiveOption));
+            } else {
+                // Wildcard searching
+                m_windowRegexCache.insert(pattern,
+                                          Tools::convertToRegex(pattern,
+                                                                Tools::RegexConvertOpts::EXACT_MATCH
+                                                                    | Tools::RegexConvertOpts::WILDCARD_UNLIMITED_MATCH));
+            }
+        }
+        return m_windowRegexCache.value(pattern).match(windowTitle).hasMatch();
     };
 
     auto windowMatchesTitle = [&](const QString& entryTitle) {
@@ -318,12 +335,13 @@ QList<QString> Entry::autoTypeSequences(const QString& windowTitle) const
             return true;
         }
 
-        QUrl url(entryUrl);
-        if (url.isValid() && !url.host().isEmpty()) {
-            return windowTitle.contains(url.host(), Qt::CaseInsensitive);
+        if (m_autoTypeUrlHost.first != entryUrl) {
+            QUrl url(entryUrl);
+            m_autoTypeUrlHost = qMakePair(entryUrl, url.isValid() ? url.host() : QString());
         }
 
-        return false;
+        const QString& host = m_autoTypeUrlHost.second;
+        return !host.isEmpty() && windowTitle.contains(host, Qt::CaseInsensitive);
     };
 
     QList<QString> sequenceList;
@@ -618,7 +636,11 @@ QString Entry::path() const
 void Entry::setUuid(const QUuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
-    set(m_uuid, uuid);
+    QUuid oldUuid = m_uuid;
+    if (set(m_uuid, uuid) && m_group && m_group->database()) {
+        m_group->database()->removeFromUuidIndex(this, oldUuid);
+        m_group->database()->addToUuidIndex(this);
+    }
 }
 
 void Entry::setIcon(int iconNumber)
@@ -1001,12 +1023,31 @@ bool Entry::endUpdate()
     return m_modifiedSinceBegin;
 }
 
+void Entry::updateDatabaseIndexes()
+{
+    if (m_group && m_group->database()) {
+        m_group->database()->addToReferenceIndex(this);
+        m_group->database()->addToUrlIndex(this);
+        m_group->database()->addToAutoTypeIndex(this);
+    }
+}
+
+void Entry::updateAutoTypeIndex()
+{
+    m_windowRegexCache.clear();
+    if (m_group && m_group->database()) {
+        m_group->database()->addToAutoTypeIndex(this);
+    }
+}
+
 void Entry::updateModifiedSinceBegin()
 {
     m_modifiedSinceBegin = true;
 }
 
-QString Entry::resolveMultiplePlaceholdersRecursive(const QString& str, int maxDepth) const
+QString Entry::resolveMultiplePlaceholdersRecursive(const QString& str,
+                                                   int maxDepth,
+                                                   PlaceholderDependencies* dependencies) const
 {
     static QRegularExpression placeholderRegEx("(\\{[^\\}]+?\\})", QRegularExpression::CaseInsensitiveOption);
 
@@ -1020,17 +1061,19 @@ QString Entry::resolveMultiplePlaceholdersRecursive(const QString& str, int maxD
     while (matches.hasNext()) {
         auto match = matches.next();
         const auto found = match.captured(1);
-        result.replace(found, resolvePlaceholderRecursive(found, maxDepth - 1));
+        result.replace(found, resolvePlaceholderRecursive(found, maxDepth - 1, dependencies));
     }
 
     if (result != str) {
-        result = resolveMultiplePlaceholdersRecursive(result, maxDepth - 1);
+        result = resolveMultiplePlaceholdersRecursive(result, maxDepth - 1, dependencies);
     }
 
     return result;
 }
 
-QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDepth) const
+QString Entry::resolvePlaceholderRecursive(const QString& placeholder,
+                                          int maxDepth,
+                                          PlaceholderDependencies* dependencies) const
 {
     if (maxDepth <= 0) {
         qWarning("Maximum depth of replacement has been reached. Entry uuid: %s", uuid().toString().toLatin1().data());
@@ -1041,33 +1084,36 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
     switch (typeOfPlaceholder) {
     case PlaceholderType::NotPlaceholder:
     case PlaceholderType::Unknown:
-        return resolveMultiplePlaceholdersRecursive(placeholder, maxDepth - 1);
+        return resolveMultiplePlaceholdersRecursive(placeholder, maxDepth - 1, dependencies);
     case PlaceholderType::Title:
         if (placeholderType(title()) == PlaceholderType::Title) {
             return title();
         }
-        return resolveMultiplePlaceholdersRecursive(title(), maxDepth - 1);
+        return resolveMultiplePlaceholdersRecursive(title(), maxDepth - 1, dependencies);
     case PlaceholderType::UserName:
         if (placeholderType(username()) == PlaceholderType::UserName) {
             return username();
         }
-        return resolveMultiplePlaceholdersRecursive(username(), maxDepth - 1);
+        return resolveMultiplePlaceholdersRecursive(username(), maxDepth - 1, dependencies);
     case PlaceholderType::Password:
         if (placeholderType(password()) == PlaceholderType::Password) {
             return password();
         }
-        return resolveMultiplePlaceholdersRecursive(password(), maxDepth - 1);
+        return resolveMultiplePlaceholdersRecursive(password(), maxDepth - 1, dependencies);
     case PlaceholderType::Notes:
         if (placeholderType(notes()) == PlaceholderType::Notes) {
             return notes();
         }
-        return resolveMultiplePlaceholdersRecursive(notes(), maxDepth - 1);
+        return resolveMultiplePlaceholdersRecursive(notes(), maxDepth - 1, dependencies);
     case PlaceholderType::Url:
         if (placeholderType(url()) == PlaceholderType::Url) {
             return url();
         }
-        return resolveMultiplePlaceholdersRecursive(url(), maxDepth - 1);
+        return resolveMultiplePlaceholdersRecursive(url(), maxDepth - 1, dependencies);
     case PlaceholderType::DbDir: {
+        if (dependencies) {
+            dependencies->isVolatile = true;
+        }
         QFileInfo fileInfo(database()->filePath());
         return fileInfo.absoluteDir().absolutePath();
     }
@@ -1081,10 +1127,13 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
     case PlaceholderType::UrlUserInfo:
     case PlaceholderType::UrlUserName:
     case PlaceholderType::UrlPassword: {
-        const QString strUrl = resolveMultiplePlaceholdersRecursive(url(), maxDepth - 1);
+        const QString strUrl = resolveMultiplePlaceholdersRecursive(url(), maxDepth - 1, dependencies);
         return resolveUrlPlaceholder(strUrl, typeOfPlaceholder);
     }
     case PlaceholderType::Totp:
+        if (dependencies) {
+            dependencies->isVolatile = true;
+        }
         // totp can't have placeholder inside
         return totp();
     case PlaceholderType::CustomAttribute: {
@@ -1092,7 +1141,7 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
         return attributes()->hasKey(key) ? attributes()->value(key) : QString();
     }
     case PlaceholderType::Reference:
-        return resolveReferencePlaceholderRecursive(placeholder, maxDepth);
+        return resolveReferencePlaceholderRecursive(placeholder, maxDepth, dependencies);
     case PlaceholderType::DateTimeSimple:
     case PlaceholderType::DateTimeYear:
     case PlaceholderType::DateTimeMonth:
@@ -1107,7 +1156,10 @@ QString Entry::resolvePlaceholderRecursive(const QString& placeholder, int maxDe
     case PlaceholderType::DateTimeUtcHour:
     case PlaceholderType::DateTimeUtcMinute:
     case PlaceholderType::DateTimeUtcSecond:
-        return resolveMultiplePlaceholdersRecursive(resolveDateTimePlaceholder(typeOfPlaceholder), maxDepth - 1);
+        if (dependencies) {
+            dependencies->isVolatile = true;
+        }
+        return resolveMultiplePlaceholdersRecursive(resolveDateTimePlaceholder(typeOfPlaceholder), maxDepth - 1, dependencies);
     }
 
     return placeholder;
@@ -1171,7 +1223,9 @@ QString Entry::resolveDateTimePlaceholder(Entry::PlaceholderType placeholderType
     return date_formatted;
 }
 
-QString Entry::resolveReferencePlaceholderRecursive(const QString& placeholder, int maxDepth) const
+QString Entry::resolveReferencePlaceholderRecursive(const QString& placeholder,
+                                                   int maxDepth,
+                                                   PlaceholderDependencies* dependencies) const
 {
     if (maxDepth <= 0) {
         qWarning("Maximum depth of replacement has been reached. Entry uuid: %s", uuid().toString().toLatin1().data());
@@ -1192,7 +1246,13 @@ QString Entry::resolveReferencePlaceholderRecursive(const QString& placeholder,
 
     const EntryReferenceType searchInType = Entry::referenceType(searchIn);
 
-    const Entry* refEntry = m_group->database()->rootGroup()->findEntryBySearchTerm(searchText, searchInType);
+    const Entry* refEntry = findReferencedEntry(searchInType, searchText);
+    if (dependencies) {
+        dependencies->references.append({this, database(), searchInType, searchText, refEntry, refEntry != nullptr});
+        if (refEntry) {
+            dependencies->entries.append(qMakePair(QPointer<const Entry>(refEntry), refEntry->attributes()->revision()));
+        }
+    }
 
     if (refEntry) {
         const QString wantedField = match.captured(EntryAttributes::WantedFieldGroupName);
@@ -1201,12 +1261,45 @@ QString Entry::resolveReferencePlaceholderRecursive(const QString& placeholder,
         // Referencing fields of other entries only works with standard fields, not with custom user strings.
         // If you want to reference a custom user string, you need to place a redirection in a standard field
         // of the entry with the custom string, using {S:<Name>}, and reference the standard field.
-        result = refEntry->resolveMultiplePlaceholdersRecursive(result, maxDepth - 1);
+        result = refEntry->resolveMultiplePlaceholdersRecursive(result, maxDepth - 1, dependencies);
     }
 
     return result;
 }
 
+const Entry* Entry::findReferencedEntry(EntryReferenceType searchInType, const QString& searchText) const
+{
+    if (!m_group || !m_group->database()) {
+        return nullptr;
+    }
+    return m_group->database()->rootGroup()->findEntryBySearchTerm(searchText, searchInType);
+}
+
+/**
+ * Check whether placeholders resolved with the given dependencies would still resolve to the same value.
+ */
+bool Entry::isCurrent(const PlaceholderDependencies& dependencies)
+{
+    if (dependencies.isVolatile) {
+        return false;
+    }
+    for (const auto& entry : dependencies.entries) {
+        if (!entry.first || entry.first->attributes()->revision() != entry.second) {
+            return false;
+        }
+    }
+    for (const auto& reference : dependencies.references) {
+        if (!reference.entry || reference.entry->database() != reference.database) {
+            return false;
+        }
+        const Entry* refEntry = reference.entry->findReferencedEntry(reference.searchIn, reference.searchText);
+        if (reference.found ? (!refEntry || refEntry != reference.result) : refEntry != nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
 QString Entry::referenceFieldValue(EntryReferenceType referenceType) const
 {
     switch (referenceType) {
@@ -1329,9 +1422,35 @@ Entry* Entry::resolveReference(const QString& str) const
     return m_group->database()->rootGroup()->findEntryBySearchTerm(searchText, searchInType);
 }
 
+/**
+ * Resolve all placeholders in the given string.
+ *
+ * Results are cached per entry until the attributes of this entry or of any entry referenced
+ * while resolving change. Results depending on the current time are never cached.
+ */
 QString Entry::resolveMultiplePlaceholders(const QString& str) const
 {
-    return resolveMultiplePlaceholdersRecursive(str, ResolveMaximumDepth);
+    if (!str.contains(QLatin1Char('{'))) {
+        return str;
+    }
+
+    if (m_placeholderCacheRevision != m_attributes->revision()
+        || m_placeholderCache.size() >= PlaceholderCacheMaximumSize) {
+        m_placeholderCache.clear();
+        m_placeholderCacheRevision = m_attributes->revision();
+    }
+
+    const auto cached = m_placeholderCache.constFind(str);
+    if (cached != m_placeholderCache.constEnd() && isCurrent(cached->dependencies)) {
+        return cached->value;
+    }
+
+    PlaceholderDependencies dependencies;
+    const QString result = resolveMultiplePlaceholdersRecursive(str, ResolveMaximumDepth, &dependencies);
+    if (!dependencies.isVolatile) {
+        m_placeholderCache.insert(str, {result, dependencies});
+    }
+    return result;
 }
 
 QString Entry::resolvePlaceholder(const QString& placeholder) const
@@ -19,8 +19,10 @@
 #ifndef KEEPASSX_ENTRY_H
 #define KEEPASSX_ENTRY_H
 
+#include <QHash>
 #include <QMap>
 #include <QPointer>
+#include <QRegularExpression>
 #include <QUuid>
 
 #include "core/AutoTypeAssociations.h"
@@ -276,11 +278,49 @@ private slots:
     void updateTimeinfo();
     void updateModifiedSinceBegin();
     void updateTotp();
+    void updateDatabaseIndexes();
+    void updateAutoTypeIndex();
 
 private:
-    QString resolveMultiplePlaceholdersRecursive(const QString& str, int maxDepth) const;
-    QString resolvePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
-    QString resolveReferencePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
+    struct PlaceholderReference
+    {
+        QPointer<const Entry> entry;
+        QPointer<const Database> database;
+        EntryReferenceType searchIn;
+        QString searchText;
+        QPointer<const Entry> result;
+        bool found;
+    };
+
+    /**
+     * Everything a resolved placeholder value depends on besides the attributes of the resolving entry.
+     */
+    struct PlaceholderDependencies
+    {
+        // Set for placeholders which resolve differently over time, like {TOTP} or {DT_SIMPLE}
+        bool isVolatile = false;
+        // Referenced entries and the revision of their attributes
+        QList<QPair<QPointer<const Entry>, quint64>> entries;
+        QList<PlaceholderReference> references;
+    };
+
+    struct PlaceholderCacheItem
+    {
+        QString value;
+        PlaceholderDependencies dependencies;
+    };
+
+    QString resolveMultiplePlaceholdersRecursive(const QString& str,
+                                                 int maxDepth,
+                                                 PlaceholderDependencies* dependencies = nullptr) const;
+    QString resolvePlaceholderRecursive(const QString& placeholder,
+                                        int maxDepth,
+                                        PlaceholderDependencies* dependencies = nullptr) const;
+    QString resolveReferencePlaceholderRecursive(const QString& placeholder,
+                                                 int maxDepth,
+                                                 PlaceholderDependencies* dependencies = nullptr) const;
+    const Entry* findReferencedEntry(EntryReferenceType searchInType, const QString& searchText) const;
+    static bool isCurrent(const PlaceholderDependencies& dependencies);
     QString referenceFieldValue(EntryReferenceType referenceType) const;
 
     static QString buildReference(const QUuid& uuid, const QString& field);
@@ -300,6 +340,14 @@ private:
     bool m_modifiedSinceBegin;
     QPointer<Group> m_group;
     bool m_updateTimeinfo;
+
+    mutable QHash<QString, PlaceholderCacheItem> m_placeholderCache;
+    mutable quint64 m_placeholderCacheRevision = 0;
+    static const int PlaceholderCacheMaximumSize;
+
+    // Compiled window association patterns by resolved pattern, and the host of the resolved URL
+    mutable QHash<QString, QRegularExpression> m_windowRegexCache;
+    mutable QPair<QString, QString> m_autoTypeUrlHost;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Entry::CloneFlags)
@@ -131,6 +131,7 @@ void EntryAttributes::set(const QString& key, const QString& value, bool protect
 
     if (addAttribute || changeValue) {
         m_attributes.insert(key, value);
+        ++m_revision;
         shouldEmitModified = true;
     }
 
@@ -143,6 +144,9 @@ void EntryAttributes::set(const QString& key, const QString& value, bool protect
         shouldEmitModified = true;
     }
 
+    if (addAttribute || changeValue) {
+        emit valuesChanged();
+    }
     if (shouldEmitModified) {
         emitModified();
     }
@@ -168,8 +172,10 @@ void EntryAttributes::remove(const QString& key)
 
     m_attributes.remove(key);
     m_protectedAttributes.remove(key);
+    ++m_revision;
 
     emit removed(key);
+    emit valuesChanged();
     emitModified();
 }
 
@@ -199,7 +205,9 @@ void EntryAttributes::rename(const QString& oldKey, const QString& newKey)
         m_protectedAttributes.remove(oldKey);
         m_protectedAttributes.insert(newKey);
     }
+    ++m_revision;
 
+    emit valuesChanged();
     emitModified();
     emit renamed(oldKey, newKey);
 }
@@ -230,8 +238,10 @@ void EntryAttributes::copyCustomKeysFrom(const EntryAttributes* other)
             }
         }
     }
+    ++m_revision;
 
     emit reset();
+    emit valuesChanged();
     emitModified();
 }
 
@@ -263,8 +273,10 @@ void EntryAttributes::copyDataFrom(const EntryAttributes* other)
 
         m_attributes = other->m_attributes;
         m_protectedAttributes = other->m_protectedAttributes;
+        ++m_revision;
 
         emit reset();
+        emit valuesChanged();
         emitModified();
     }
 }
@@ -316,8 +328,10 @@ void EntryAttributes::clear()
     for (const QString& key : DefaultAttributes) {
         m_attributes.insert(key, "");
     }
+    ++m_revision;
 
     emit reset();
+    emit valuesChanged();
     emitModified();
 }
 
@@ -330,6 +344,15 @@ int EntryAttributes::attributesSize() const
     return size;
 }
 
+/**
+ * Counter increased on every change of the attribute keys or values,
+ * used to detect whether values derived from the attributes are still current.
+ */
+quint64 EntryAttributes::revision() const
+{
+    return m_revision;
+}
+
 bool EntryAttributes::isDefaultAttribute(const QString& key)
 {
     return DefaultAttributes.contains(key);
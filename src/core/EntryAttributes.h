@@ -48,6 +48,7 @@ public:
     bool areCustomKeysDifferent(const EntryAttributes* other);
     void clear();
     int attributesSize() const;
+    quint64 revision() const;
     void copyDataFrom(const EntryAttributes* other);
     QUuid referenceUuid(const QString& key) const;
     bool operator==(const EntryAttributes& other) const;
@@ -82,10 +83,13 @@ signals:
     void renamed(const QString& oldKey, const QString& newKey);
     void aboutToBeReset();
     void reset();
+    // Emitted on every change of keys or values, even while modified signals are disabled
+    void valuesChanged();
 
 private:
     QMap<QString, QString> m_attributes;
     QSet<QString> m_protectedAttributes;
+    quint64 m_revision = 0;
 };
 
 #endif // KEEPASSX_ENTRYATTRIBUTES_H
@@ -19,9 +19,247 @@
 #include "EntrySearcher.h"
 
 #include "PasswordHealth.h"
+#include "core/Clock.h"
+#include "core/Global.h"
 #include "core/Group.h"
 #include "core/Tools.h"
 
+#include <QSet>
+
+namespace
+{
+    /**
+     * Searchable fields of an entry of the database
+     */
+    class LiveEntry
+    {
+    public:
+        explicit LiveEntry(const Entry* entry)
+            : m_entry(entry)
+        {
+        }
+
+        QString title() const
+        {
+            return m_entry->resolvePlaceholder(m_entry->title());
+        }
+
+        QString username() const
+        {
+            return m_entry->resolvePlaceholder(m_entry->username());
+        }
+
+        QString password() const
+        {
+            return m_entry->resolvePlaceholder(m_entry->password());
+        }
+
+        QString url() const
+        {
+            return m_entry->resolvePlaceholder(m_entry->url());
+        }
+
+        QString notes() const
+        {
+            return m_entry->notes();
+        }
+
+        QString uuid() const
+        {
+            return m_entry->uuidToHex();
+        }
+
+        QStringList tagList() const
+        {
+            return m_entry->tagList();
+        }
+
+        // Loaded on first use, most searches do not need them
+        const QStringList& customAttributes() const
+        {
+            if (!m_attributesLoaded) {
+                const auto keys = m_entry->attributes()->customKeys();
+                m_attributes = QStringList(keys + m_entry->attributes()->values(keys));
+                m_attributesLoaded = true;
+            }
+            return m_attributes;
+        }
+
+        QStringList attachments() const
+        {
+            return QStringList(m_entry->attachments()->keys());
+        }
+
+        bool hasAttribute(const QString& key) const
+        {
+            return m_entry->attributes()->contains(key);
+        }
+
+        QString attribute(const QString& key) const
+        {
+            return m_entry->attributes()->value(key);
+        }
+
+        bool isProtected(const QString& key) const
+        {
+            return m_entry->attributes()->isProtected(key);
+        }
+
+        bool hasGroup() const
+        {
+            return m_entry->group() != nullptr;
+        }
+
+        QString groupName() const
+        {
+            return m_entry->group()->name();
+        }
+
+        // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
+        const QString& hierarchy() const
+        {
+            if (!m_hierarchyLoaded && m_entry->group()) {
+                m_hierarchy = m_entry->group()->hierarchy().join('/').prepend("/");
+            }
+            m_hierarchyLoaded = true;
+            return m_hierarchy;
+        }
+
+        bool willExpireInDays(int days) const
+        {
+            return m_entry->willExpireInDays(days);
+        }
+
+        bool isRecycled() const
+        {
+            return m_entry->isRecycled();
+        }
+
+        bool isWeak() const
+        {
+            if (m_entry->excludeFromReports() || m_entry->password().isEmpty() || m_entry->isExpired()) {
+                return false;
+            }
+            const auto quality = m_entry->passwordHealth()->quality();
+            return quality == PasswordHealth::Quality::Bad || quality == PasswordHealth::Quality::Poor
+                   || quality == PasswordHealth::Quality::Weak;
+        }
+
+    private:
+        const Entry* m_entry;
+        mutable QStringList m_attributes;
+        mutable bool m_attributesLoaded = false;
+        mutable QString m_hierarchy;
+        mutable bool m_hierarchyLoaded = false;
+    };
+
+    /**
+     * Searchable fields of an entry snapshot, safe to use on any thread
+     */
+    class SnapshotEntry
+    {
+    public:
+        explicit SnapshotEntry(const EntrySearcher::EntrySnapshot& entry)
+            : m_entry(entry)
+        {
+        }
+
+        const QString& title() const
+        {
+            return m_entry.title;
+        }
+
+        const QString& username() const
+        {
+            return m_entry.username;
+        }
+
+        const QString& password() const
+        {
+            return m_entry.password;
+        }
+
+        const QString& url() const
+        {
+            return m_entry.url;
+        }
+
+        const QString& notes() const
+        {
+            return m_entry.notes;
+        }
+
+        const QString& uuid() const
+        {
+            return m_entry.uuid;
+        }
+
+        const QStringList& tagList() const
+        {
+            return m_entry.tags;
+        }
+
+        const QStringList& customAttributes() const
+        {
+            return m_entry.customAttributes;
+        }
+
+        const QStringList& attachments() const
+        {
+            return m_entry.attachments;
+        }
+
+        bool hasAttribute(const QString& key) const
+        {
+            return m_entry.attributes.contains(key);
+        }
+
+        QString attribute(const QString& key) const
+        {
+            return m_entry.attributes.value(key);
+        }
+
+        bool isProtected(const QString& key) const
+        {
+            return m_entry.protectedAttributes.contains(key);
+        }
+
+        bool hasGroup() const
+        {
+            return m_entry.hasGroup;
+        }
+
+        const QString& groupName() const
+        {
+            return m_entry.groupName;
+        }
+
+        const QString& hierarchy() const
+        {
+            return m_entry.hierarchy;
+        }
+
+        bool willExpireInDays(int days) const
+        {
+            return m_entry.expires && m_entry.expiryTime < Clock::currentDateTime().addDays(days);
+        }
+
+        bool isRecycled() const
+        {
+            return m_entry.recycled;
+        }
+
+        bool isWeak() const
+        {
+            // Excluded by EntrySearcher::canSearchSnapshot()
+            return false;
+        }
+
+    private:
+        const EntrySearcher::EntrySnapshot& m_entry;
+    };
+} // namespace
+
 EntrySearcher::EntrySearcher(bool caseSensitive, bool skipProtected)
     : m_caseSensitive(caseSensitive)
     , m_skipProtected(skipProtected)
@@ -39,6 +277,7 @@ QList<Entry*> EntrySearcher::search(const QList<SearchTerm>& searchTerms, const
 {
     Q_ASSERT(baseGroup);
     m_searchTerms = searchTerms;
+    m_plainTerms.clear();
     return repeat(baseGroup, forceSearch);
 }
 
@@ -70,7 +309,7 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
     Q_ASSERT(baseGroup);
 
     QList<Entry*> results;
-    for (const auto group : baseGroup->groupsRecursive(true)) {
+    baseGroup->forEachGroupRecursive([this, &results, forceSearch](const Group* group) {
         if (forceSearch || group->resolveSearchingEnabled()) {
             for (const auto entry : group->entries()) {
                 if (searchEntryImpl(entry)) {
@@ -78,10 +317,370 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
                 }
             }
         }
+    });
+    return results;
+}
+
+/**
+ * Search like search(), but only filter the results of the previous call
+ * if the new search string narrows down the previous one. This is the case
+ * when words of the previous terms got longer or more terms were added, e.g.
+ * while the user is typing.
+ *
+ * The cached results have to be discarded using clearCache() whenever the
+ * searched entries change.
+ *
+ * @param searchString search terms
+ * @param baseGroup group to start search from, cannot be null
+ * @param forceSearch ignore group search settings
+ * @return list of entries that match the search terms
+ */
+QList<Entry*> EntrySearcher::searchIncremental(const QString& searchString, const Group* baseGroup, bool forceSearch)
+{
+    Q_ASSERT(baseGroup);
+    parseSearchTerms(searchString);
+
+    QList<Entry*> results;
+    QStringList tagWords;
+    if (m_cache.baseGroup == baseGroup && m_cache.forceSearch == forceSearch && narrowsCachedSearch(tagWords)) {
+        results = refineCachedResults(baseGroup, forceSearch, tagWords);
+    } else {
+        results = repeat(baseGroup, forceSearch);
+    }
+
+    m_cache.valid = true;
+    m_cache.baseGroup = baseGroup;
+    m_cache.forceSearch = forceSearch;
+    m_cache.caseSensitive = m_caseSensitive;
+    m_cache.searchTerms = m_searchTerms;
+    m_cache.plainTerms = m_plainTerms;
+    m_cache.snapshot.reset();
+    m_cache.snapshotResults.clear();
+    m_cache.results.clear();
+    m_cache.results.reserve(results.size());
+    for (auto entry : asConst(results)) {
+        m_cache.results.append(entry);
+    }
+    return results;
+}
+
+/**
+ * Discard the results cached by searchIncremental()
+ */
+void EntrySearcher::clearCache()
+{
+    m_cache = {};
+}
+
+/**
+ * Check whether every entry matching the current search terms
+ * also matches the terms of the cached search. The caller has to
+ * make sure the same entries were searched.
+ *
+ * Tags are matched exactly instead of by substring, so entries missing
+ * from the cached results may still match a longer word through a tag.
+ * The words of such terms are returned in tagWords.
+ */
+bool EntrySearcher::narrowsCachedSearch(QStringList& tagWords) const
+{
+    const auto& cachedTerms = m_cache.searchTerms;
+    if (!m_cache.valid || m_cache.caseSensitive != m_caseSensitive || cachedTerms.isEmpty()
+        || cachedTerms.size() > m_searchTerms.size() || m_cache.plainTerms.size() != cachedTerms.size()
+        || m_plainTerms.size() != m_searchTerms.size()) {
+        return false;
+    }
+
+    const auto cs = m_caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    tagWords.clear();
+    // Additional terms can only narrow down the results, check the ones that were present before
+    for (int i = 0; i < cachedTerms.size(); ++i) {
+        const auto& cached = cachedTerms.at(i);
+        const auto& term = m_searchTerms.at(i);
+        if (cached.field != term.field || cached.exclude != term.exclude) {
+            return false;
+        }
+        if (cached.word == term.word && cached.regex == term.regex) {
+            continue;
+        }
+        if (cached.exclude || !m_cache.plainTerms.at(i) || !m_plainTerms.at(i) || !term.word.contains(cached.word, cs)) {
+            return false;
+        }
+
+        switch (term.field) {
+        case Field::Is:
+        case Field::AttributeValue:
+            return false;
+        case Field::Group:
+            // Switching between group name and hierarchy matching
+            if (cached.word.contains('/') != term.word.contains('/')) {
+                return false;
+            }
+            break;
+        case Field::Undefined:
+        case Field::Tag:
+            tagWords << term.word;
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * Apply the current search terms to the cached results only, as well as to
+ * entries that could newly match through one of the given tag words.
+ */
+QList<Entry*> EntrySearcher::refineCachedResults(const Group* baseGroup, bool forceSearch, const QStringList& tagWords)
+{
+    QList<Entry*> results;
+    if (tagWords.isEmpty()) {
+        for (const auto& entry : asConst(m_cache.results)) {
+            if (entry && searchEntryImpl(entry)) {
+                results.append(entry);
+            }
+        }
+        return results;
     }
+
+    QSet<const Entry*> previous;
+    for (const auto& entry : asConst(m_cache.results)) {
+        if (entry) {
+            previous.insert(entry);
+        }
+    }
+
+    // Walk the tree to keep the results in order, but skip the full match for
+    // entries that did not match before and have none of the tag words
+    const auto cs = m_caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    baseGroup->forEachGroupRecursive([&](const Group* group) {
+        if (forceSearch || group->resolveSearchingEnabled()) {
+            for (const auto entry : group->entries()) {
+                if (!previous.contains(entry)) {
+                    const auto tags = entry->tags();
+                    bool hasTagWord = false;
+                    for (const auto& word : tagWords) {
+                        if (tags.contains(word, cs)) {
+                            hasTagWord = true;
+                            break;
+                        }
+                    }
+                    if (!hasTagWord) {
+                        continue;
+                    }
+                }
+                if (searchEntryImpl(entry)) {
+                    results.append(entry);
+                }
+            }
+        }
+    });
     return results;
 }
 
+/**
+ * Copy the searchable data of the entries of a group and its children.
+ *
+ * Passwords, custom attributes and attribute values are only copied if the given
+ * search string refers to them, see snapshotCovers().
+ *
+ * @param baseGroup group to start from, cannot be null
+ * @param searchString search the snapshot is taken for
+ * @param forceSearch ignore group search settings
+ * @return entries in the order they are searched by search()
+ */
+QSharedPointer<const EntrySearcher::Snapshot>
+EntrySearcher::takeSnapshot(const Group* baseGroup, const QString& searchString, bool forceSearch)
+{
+    Q_ASSERT(baseGroup);
+
+    auto resolve = [](const Entry* entry, const QString& value) {
+        return value.contains('{') ? entry->resolvePlaceholder(value) : value;
+    };
+
+    auto snapshot = QSharedPointer<Snapshot>::create(snapshotFields(searchString));
+    baseGroup->forEachGroupRecursive([&](const Group* group) {
+        if (!forceSearch && !group->resolveSearchingEnabled()) {
+            return;
+        }
+        const auto hierarchy = group->hierarchy().join('/').prepend("/");
+        for (const auto entry : group->entries()) {
+            EntrySnapshot data;
+            data.entry = entry;
+            data.title = resolve(entry, entry->title());
+            data.username = resolve(entry, entry->username());
+            if (snapshot->hasPasswords) {
+                data.password = resolve(entry, entry->password());
+            }
+            data.url = resolve(entry, entry->url());
+            data.notes = entry->notes();
+            data.uuid = entry->uuidToHex();
+            data.tags = entry->tagList();
+
+            const auto attributes = entry->attributes();
+            for (const auto& key : attributes->keys()) {
+                if (snapshot->attributeKeys.contains(key)) {
+                    data.attributes.insert(key, attributes->value(key));
+                }
+                if (attributes->isProtected(key)) {
+                    data.protectedAttributes.insert(key);
+                }
+            }
+            if (snapshot->hasCustomAttributes) {
+                const auto customKeys = attributes->customKeys();
+                data.customAttributes = QStringList(customKeys + attributes->values(customKeys));
+            }
+            data.attachments = QStringList(entry->attachments()->keys());
+
+            data.hasGroup = true;
+            data.groupName = group->name();
+            data.hierarchy = hierarchy;
+            data.expires = entry->timeInfo().expires();
+            data.expiryTime = entry->timeInfo().expiryTime();
+            data.recycled = entry->isRecycled();
+            snapshot->entries.append(data);
+        }
+    });
+    return snapshot;
+}
+
+/**
+ * Sensitive fields a snapshot needs to contain for the given search.
+ */
+EntrySearcher::Snapshot EntrySearcher::snapshotFields(const QString& searchString)
+{
+    EntrySearcher searcher;
+    searcher.parseSearchTerms(searchString);
+
+    Snapshot fields;
+    for (const auto& term : asConst(searcher.m_searchTerms)) {
+        if (term.field == Field::Password) {
+            fields.hasPasswords = true;
+        } else if (term.field == Field::AttributeKV) {
+            fields.hasCustomAttributes = true;
+        } else if (term.field == Field::AttributeValue) {
+            fields.attributeKeys.insert(term.word);
+        }
+    }
+    return fields;
+}
+
+/**
+ * Check whether a snapshot contains all fields the given search looks at.
+ */
+bool EntrySearcher::snapshotCovers(const Snapshot& snapshot, const QString& searchString)
+{
+    const auto fields = snapshotFields(searchString);
+    return (snapshot.hasPasswords || !fields.hasPasswords)
+           && (snapshot.hasCustomAttributes || !fields.hasCustomAttributes)
+           && snapshot.attributeKeys.contains(fields.attributeKeys);
+}
+
+/**
+ * Check whether a search can run on a snapshot. This is not the case for searches
+ * that need data computed on demand, like the password health of is:weak.
+ */
+bool EntrySearcher::canSearchSnapshot(const QString& searchString)
+{
+    EntrySearcher searcher;
+    searcher.parseSearchTerms(searchString);
+    for (const auto& term : asConst(searcher.m_searchTerms)) {
+        if (term.field == Field::Is && term.word.compare("weak", Qt::CaseInsensitive) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Search a snapshot taken by takeSnapshot(). This may run on any thread,
+ * as long as calls on the same searcher do not overlap.
+ *
+ * Like searchIncremental(), only the previous results are searched again if the
+ * search string narrows down the previous search of the same snapshot.
+ *
+ * @param searchString search terms
+ * @param snapshot entries to search
+ * @param progress receives the indexes of matching entries in batches, in the order
+ *        of the snapshot. It is called at least every SnapshotBatchSize entries, even
+ *        without new matches, and aborts the search by returning false.
+ * @return false if the search was aborted
+ */
+bool EntrySearcher::searchSnapshot(const QString& searchString,
+                                   const QSharedPointer<const Snapshot>& snapshot,
+                                   const SnapshotProgress& progress)
+{
+    Q_ASSERT(snapshot);
+    parseSearchTerms(searchString);
+
+    QStringList tagWords;
+    const bool refine = snapshot && m_cache.snapshot == snapshot && narrowsCachedSearch(tagWords);
+
+    QList<int> results;
+    QList<int> batch;
+    int scanned = 0;
+    auto check = [&](int index) {
+        if (matchEntry(SnapshotEntry(snapshot->at(index)))) {
+            batch.append(index);
+        }
+        if (++scanned % SnapshotBatchSize == 0) {
+            if (!progress(batch)) {
+                return false;
+            }
+            results.append(batch);
+            batch.clear();
+        }
+        return true;
+    };
+
+    if (refine && tagWords.isEmpty()) {
+        for (int index : asConst(m_cache.snapshotResults)) {
+            if (!check(index)) {
+                return false;
+            }
+        }
+    } else {
+        QSet<int> previous;
+        if (refine) {
+            previous = QSet<int>::fromList(m_cache.snapshotResults);
+        }
+        const auto cs = m_caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+        for (int index = 0; index < snapshot->size(); ++index) {
+            // See refineCachedResults() for why tags need to be considered
+            if (refine && !previous.contains(index)) {
+                const auto tags = snapshot->at(index).tags.join(';');
+                bool hasTagWord = false;
+                for (const auto& word : tagWords) {
+                    if (tags.contains(word, cs)) {
+                        hasTagWord = true;
+                        break;
+                    }
+                }
+                if (!hasTagWord) {
+                    continue;
+                }
+            }
+            if (!check(index)) {
+                return false;
+            }
+        }
+    }
+
+    if (!progress(batch)) {
+        return false;
+    }
+    results.append(batch);
+
+    m_cache = {};
+    m_cache.valid = true;
+    m_cache.caseSensitive = m_caseSensitive;
+    m_cache.searchTerms = m_searchTerms;
+    m_cache.plainTerms = m_plainTerms;
+    m_cache.snapshot = snapshot;
+    m_cache.snapshotResults = results;
+    return true;
+}
+
 /**
  * Search provided entries by the provided search terms
  *
@@ -92,6 +691,7 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
 QList<Entry*> EntrySearcher::searchEntries(const QList<SearchTerm>& searchTerms, const QList<Entry*>& entries)
 {
     m_searchTerms = searchTerms;
+    m_plainTerms.clear();
     return repeatEntries(entries);
 }
 
@@ -143,62 +743,56 @@ bool EntrySearcher::isCaseSensitive() const
 
 bool EntrySearcher::searchEntryImpl(const Entry* entry)
 {
-    // Pre-load in case they are needed
-    auto attributes_keys = entry->attributes()->customKeys();
-    auto attributes = QStringList(attributes_keys + entry->attributes()->values(attributes_keys));
-    auto attachments = QStringList(entry->attachments()->keys());
-    // Build a group hierarchy to allow searching for e.g. /group1/subgroup*
-    QString hierarchy;
-    if (entry->group()) {
-        hierarchy = entry->group()->hierarchy().join('/').prepend("/");
-    }
+    return matchEntry(LiveEntry(entry));
+}
 
+template <class T> bool EntrySearcher::matchEntry(const T& entry) const
+{
     // By default, empty term matches every entry.
     // However when skipping protected fields, we will reject everything instead
     bool found = !m_skipProtected;
     for (const auto& term : m_searchTerms) {
         switch (term.field) {
         case Field::Title:
-            found = term.regex.match(entry->resolvePlaceholder(entry->title())).hasMatch();
+            found = term.regex.match(entry.title()).hasMatch();
             break;
         case Field::Username:
-            found = term.regex.match(entry->resolvePlaceholder(entry->username())).hasMatch();
+            found = term.regex.match(entry.username()).hasMatch();
             break;
         case Field::Password:
             if (m_skipProtected) {
                 continue;
             }
-            found = term.regex.match(entry->resolvePlaceholder(entry->password())).hasMatch();
+            found = term.regex.match(entry.password()).hasMatch();
             break;
         case Field::Url:
-            found = term.regex.match(entry->resolvePlaceholder(entry->url())).hasMatch();
+            found = term.regex.match(entry.url()).hasMatch();
             break;
         case Field::Notes:
-            found = term.regex.match(entry->notes()).hasMatch();
+            found = term.regex.match(entry.notes()).hasMatch();
             break;
         case Field::AttributeKV:
-            found = !attributes.filter(term.regex).empty();
+            found = !entry.customAttributes().filter(term.regex).empty();
             break;
         case Field::Attachment:
-            found = !attachments.filter(term.regex).empty();
+            found = !entry.attachments().filter(term.regex).empty();
             break;
         case Field::AttributeValue:
-            if (m_skipProtected && entry->attributes()->isProtected(term.word)) {
+            if (m_skipProtected && entry.isProtected(term.word)) {
                 continue;
             }
-            found = entry->attributes()->contains(term.word)
-                    && term.regex.match(entry->attributes()->value(term.word)).hasMatch();
+            found = entry.hasAttribute(term.word) && term.regex.match(entry.attribute(term.word)).hasMatch();
             break;
         case Field::Group:
             // Match against the full hierarchy if the word contains a '/' otherwise just the group name
             if (term.word.contains('/')) {
-                found = term.regex.match(hierarchy).hasMatch();
-            } else if (entry->group()) {
-                found = term.regex.match(entry->group()->name()).hasMatch();
+                found = term.regex.match(entry.hierarchy()).hasMatch();
+            } else if (entry.hasGroup()) {
+                found = term.regex.match(entry.groupName()).hasMatch();
             }
             break;
         case Field::Tag:
-            found = entry->tagList().indexOf(term.regex) != -1;
+            found = entry.tagList().indexOf(term.regex) != -1;
             break;
         case Field::Is:
             if (term.word.startsWith("expired", Qt::CaseInsensitive)) {
@@ -207,29 +801,24 @@ bool EntrySearcher::searchEntryImpl(const Entry* entry)
                 if (parts.length() >= 2) {
                     days = parts[1].toInt();
                 }
-                found = entry->willExpireInDays(days) && !entry->isRecycled();
+                found = entry.willExpireInDays(days) && !entry.isRecycled();
                 break;
             } else if (term.word.compare("weak", Qt::CaseInsensitive) == 0) {
-                if (!entry->excludeFromReports() && !entry->password().isEmpty() && !entry->isExpired()) {
-                    const auto quality = entry->passwordHealth()->quality();
-                    if (quality == PasswordHealth::Quality::Bad || quality == PasswordHealth::Quality::Poor
-                        || quality == PasswordHealth::Quality::Weak) {
-                        found = true;
-                        break;
-                    }
+                if (entry.isWeak()) {
+                    found = true;
+                    break;
                 }
             }
             found = false;
             break;
         case Field::Uuid:
-            found = term.regex.match(entry->uuidToHex()).hasMatch();
+            found = term.regex.match(entry.uuid()).hasMatch();
             break;
         default:
             // Terms without a specific field try to match title, username, url, and notes
-            found = term.regex.match(entry->resolvePlaceholder(entry->title())).hasMatch()
-                    || term.regex.match(entry->resolvePlaceholder(entry->username())).hasMatch()
-                    || term.regex.match(entry->resolvePlaceholder(entry->url())).hasMatch()
-                    || entry->tagList().indexOf(term.regex) != -1 || term.regex.match(entry->notes()).hasMatch();
+            found = term.regex.match(entry.title()).hasMatch() || term.regex.match(entry.username()).hasMatch()
+                    || term.regex.match(entry.url()).hasMatch() || entry.tagList().indexOf(term.regex) != -1
+                    || term.regex.match(entry.notes()).hasMatch();
         }
 
         // negate the result if exclude:
@@ -266,6 +855,7 @@ void EntrySearcher::parseSearchTerms(const QString& searchString)
     static QRegularExpression termParser(R"re(([-!*+]+)?(?:(\w*):)?(?:(?=")"((?:[^"\\]|\\.)*)"|([^ ]*))( |$))re");
 
     m_searchTerms.clear();
+    m_plainTerms.clear();
     auto results = termParser.globalMatch(searchString);
     while (results.hasNext()) {
         auto result = results.next();
@@ -297,6 +887,8 @@ void EntrySearcher::parseSearchTerms(const QString& searchString)
             opts |= Tools::RegexConvertOpts::EXACT_MATCH;
         }
         term.regex = Tools::convertToRegex(term.word, opts);
+        bool plain = !mods.contains("*") && !mods.contains("+") && !term.word.contains('*') && !term.word.contains('?')
+                     && !term.word.contains('|');
 
         // Exclude modifier
         term.exclude = mods.contains("-") || mods.contains("!");
@@ -323,5 +915,6 @@ void EntrySearcher::parseSearchTerms(const QString& searchString)
         }
 
         m_searchTerms.append(term);
+        m_plainTerms.append(plain);
     }
 }
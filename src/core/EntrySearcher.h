@@ -19,7 +19,14 @@
 #ifndef KEEPASSX_ENTRYSEARCHER_H
 #define KEEPASSX_ENTRYSEARCHER_H
 
+#include <QDateTime>
+#include <QPointer>
 #include <QRegularExpression>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <functional>
 
 class Group;
 class Entry;
@@ -53,11 +60,74 @@ public:
         bool exclude;
     };
 
+    /**
+     * Searchable data of an entry, copied on the thread owning the database
+     * so it can be searched on another thread.
+     */
+    struct EntrySnapshot
+    {
+        // only to be dereferenced on the thread owning the database
+        QPointer<Entry> entry;
+        QString title;
+        QString username;
+        QString password;
+        QString url;
+        QString notes;
+        QString uuid;
+        QStringList tags;
+        QStringList customAttributes;
+        QMap<QString, QString> attributes;
+        QSet<QString> protectedAttributes;
+        QStringList attachments;
+        bool hasGroup = false;
+        QString groupName;
+        QString hierarchy;
+        bool expires = false;
+        QDateTime expiryTime;
+        bool recycled = false;
+    };
+
+    /**
+     * Entries copied by takeSnapshot(). Passwords and attribute values are only
+     * copied when the search the snapshot was taken for looks at them.
+     */
+    struct Snapshot
+    {
+        QVector<EntrySnapshot> entries;
+        bool hasPasswords = false;
+        bool hasCustomAttributes = false;
+        // keys of the attributes copied into EntrySnapshot::attributes
+        QSet<QString> attributeKeys;
+
+        int size() const
+        {
+            return entries.size();
+        }
+
+        const EntrySnapshot& at(int index) const
+        {
+            return entries.at(index);
+        }
+    };
+    using SnapshotProgress = std::function<bool(const QList<int>& matches)>;
+
+    static const int SnapshotBatchSize = 1000;
+
     explicit EntrySearcher(bool caseSensitive = false, bool skipProtected = false);
 
     QList<Entry*> search(const QList<SearchTerm>& searchTerms, const Group* baseGroup, bool forceSearch = false);
     QList<Entry*> search(const QString& searchString, const Group* baseGroup, bool forceSearch = false);
     QList<Entry*> repeat(const Group* baseGroup, bool forceSearch = false);
+    QList<Entry*> searchIncremental(const QString& searchString, const Group* baseGroup, bool forceSearch = false);
+    void clearCache();
+
+    static QSharedPointer<const Snapshot>
+    takeSnapshot(const Group* baseGroup, const QString& searchString, bool forceSearch = false);
+    static bool canSearchSnapshot(const QString& searchString);
+    static bool snapshotCovers(const Snapshot& snapshot, const QString& searchString);
+    bool searchSnapshot(const QString& searchString,
+                        const QSharedPointer<const Snapshot>& snapshot,
+                        const SnapshotProgress& progress);
 
     QList<Entry*> searchEntries(const QList<SearchTerm>& searchTerms, const QList<Entry*>& entries);
     QList<Entry*> searchEntries(const QString& searchString, const QList<Entry*>& entries);
@@ -67,12 +137,32 @@ public:
     bool isCaseSensitive() const;
 
 private:
+    struct SearchCache
+    {
+        bool valid = false;
+        QPointer<const Group> baseGroup;
+        bool forceSearch = false;
+        bool caseSensitive = false;
+        QList<SearchTerm> searchTerms;
+        QList<bool> plainTerms;
+        QList<QPointer<Entry>> results;
+        QSharedPointer<const Snapshot> snapshot;
+        QList<int> snapshotResults;
+    };
+
+    static Snapshot snapshotFields(const QString& searchString);
     bool searchEntryImpl(const Entry* entry);
+    template <class T> bool matchEntry(const T& entry) const;
     void parseSearchTerms(const QString& searchString);
+    bool narrowsCachedSearch(QStringList& tagWords) const;
+    QList<Entry*> refineCachedResults(const Group* baseGroup, bool forceSearch, const QStringList& tagWords);
 
     bool m_caseSensitive;
     bool m_skipProtected;
     QList<SearchTerm> m_searchTerms;
+    // whether each parsed term is a plain word without wildcards or modifiers other than exclude
+    QList<bool> m_plainTerms;
+    SearchCache m_cache;
 
     friend class TestEntrySearcher;
 };
@@ -0,0 +1,192 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FileCopy.h"
+
+#include <QFile>
+#include <QList>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace FileCopy
+{
+#ifdef Q_OS_LINUX
+    /**
+     * Copy the first size bytes of one open file to another with copy_file_range.
+     *
+     * Fails unless all of them were copied. The syscall copies nothing at the end of the
+     * source, which happens when the source was truncated meanwhile, and on some file
+     * systems that do not implement it.
+     */
+    bool copyFileRange(int source, int destination, qint64 size)
+    {
+#ifdef SYS_copy_file_range
+        while (size > 0) {
+            auto copied = ::syscall(
+                SYS_copy_file_range, source, nullptr, destination, nullptr, static_cast<size_t>(size), 0u);
+            if (copied < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (copied == 0) {
+                return false;
+            }
+            size -= copied;
+        }
+        return true;
+#else
+        Q_UNUSED(source);
+        Q_UNUSED(destination);
+        Q_UNUSED(size);
+        return false;
+#endif
+    }
+#endif
+
+    namespace
+    {
+#ifdef Q_OS_LINUX
+        bool kernelCopy(int source, int destination, qint64 size, Method method)
+        {
+            if (method == Method::Reflink) {
+#ifdef FICLONE
+                return ::ioctl(destination, FICLONE, source) == 0;
+#else
+                return false;
+#endif
+            }
+            return copyFileRange(source, destination, size);
+        }
+
+        /**
+         * Copy a file through the kernel. A partially written destination is removed on failure.
+         */
+        bool kernelCopy(const QString& from, const QString& to, Method method)
+        {
+            int source = ::open(QFile::encodeName(from).constData(), O_RDONLY | O_CLOEXEC);
+            if (source < 0) {
+                return false;
+            }
+
+            struct stat info;
+            if (::fstat(source, &info) != 0) {
+                ::close(source);
+                return false;
+            }
+
+            int destination = ::open(QFile::encodeName(to).constData(),
+                                     O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                                     info.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+            if (destination < 0) {
+                ::close(source);
+                return false;
+            }
+
+            bool ok = kernelCopy(source, destination, info.st_size, method);
+            ok = ::close(destination) == 0 && ok;
+            ::close(source);
+
+            if (!ok) {
+                ::unlink(QFile::encodeName(to).constData());
+            }
+            return ok;
+        }
+#endif
+    } // namespace
+
+    /**
+     * Whether the method is available on this platform. A supported method can still
+     * fail for a file system that does not implement it.
+     */
+    bool isSupported(Method method)
+    {
+        switch (method) {
+        case Method::Reflink:
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+            return true;
+#else
+            return false;
+#endif
+        case Method::CopyFileRange:
+#if defined(Q_OS_LINUX) && defined(SYS_copy_file_range)
+            return true;
+#else
+            return false;
+#endif
+        case Method::Auto:
+        case Method::Buffered:
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Copy a file. Like QFile::copy() this fails if the destination already exists.
+     *
+     * Method::Auto tries a reflink first, which does not copy any data on file systems
+     * like Btrfs or XFS. Then an in-kernel copy is tried, which avoids moving the data
+     * through user space and lets network file systems copy on the server. A buffered
+     * copy is the last resort.
+     *
+     * @param from source file
+     * @param to destination file
+     * @param method copy method to use
+     * @param usedMethod receives the method the file was copied with
+     * @return true on success
+     */
+    bool copy(const QString& from, const QString& to, Method method, Method* usedMethod)
+    {
+        QList<Method> methods({method});
+        if (method == Method::Auto) {
+            methods = {Method::Reflink, Method::CopyFileRange, Method::Buffered};
+        }
+
+        for (auto candidate : methods) {
+            if (!isSupported(candidate)) {
+                continue;
+            }
+
+            bool ok = false;
+            if (candidate == Method::Buffered) {
+                ok = QFile::copy(from, to);
+            } else {
+#ifdef Q_OS_LINUX
+                ok = kernelCopy(from, to, candidate);
+#endif
+            }
+
+            if (ok) {
+                if (usedMethod) {
+                    *usedMethod = candidate;
+                }
+                return true;
+            }
+        }
+
+        return false;
+    }
+} // namespace FileCopy
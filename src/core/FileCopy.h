@@ -0,0 +1,43 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_FILECOPY_H
+#define KEEPASSX_FILECOPY_H
+
+#include <QString>
+
+/**
+ * Copy files without moving their contents through user space where the platform allows it.
+ */
+namespace FileCopy
+{
+    enum class Method
+    {
+        Auto, // use the cheapest method supported for the given files
+        Reflink, // share the data blocks of the source file (Linux FICLONE)
+        CopyFileRange, // copy inside the kernel, server side on NFS 4.2 and SMB3 (Linux copy_file_range)
+        Buffered, // read and write through QFile::copy
+    };
+
+    bool copy(const QString& from, const QString& to, Method method = Method::Auto, Method* usedMethod = nullptr);
+    bool isSupported(Method method);
+#ifdef Q_OS_LINUX
+    bool copyFileRange(int source, int destination, qint64 size);
+#endif
+} // namespace FileCopy
+
+#endif // KEEPASSX_FILECOPY_H
@@ -19,9 +19,73 @@
 
 #include "core/AsyncTask.h"
 
+#include <QFileInfo>
+#include <QSocketNotifier>
+
 #ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <sys/stat.h>
 #include <sys/statfs.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Coarsest modification time resolution of common file systems (FAT), in nanoseconds
+    constexpr qint64 TimestampGranularity = Q_INT64_C(2000000000);
+
+    /**
+     * Whether changes to the file may be made by other machines, which are not notified locally.
+     */
+    bool isNetworkFileSystem(const QString& filePath)
+    {
+#if defined(Q_OS_LINUX)
+        struct statfs statfsBuf;
+        if (statfs(QFile::encodeName(filePath).constData(), &statfsBuf)) {
+            // if we can't get the fs type let's fall back to polling
+            return true;
+        }
+
+        switch (static_cast<quint32>(statfsBuf.f_type)) {
+        case 0x6969: // NFS
+        case 0x517B: // SMB
+        case 0xFF534D42: // CIFS
+        case 0xFE534D42: // SMB2
+        case 0x65735546: // FUSE, e.g. sshfs
+        case 0x5346414F: // AFS
+        case 0x00C36400: // Ceph
+            return true;
+        default:
+            return false;
+        }
+#else
+        Q_UNUSED(filePath);
+        return false;
 #endif
+    }
+} // namespace
+
+/**
+ * Whether the file may have been written again without changing the stamp. Writes within the
+ * timestamp granularity of the file system leave the modification time unchanged, so a stamp
+ * read that soon after the last write cannot rule out a same-size rewrite.
+ */
+bool FileWatcher::FileStamp::isRacy() const
+{
+    return exists && read - qMax(modified, changed) < TimestampGranularity;
+}
+
+bool FileWatcher::FileStamp::operator==(const FileStamp& other) const
+{
+    return exists == other.exists && size == other.size && modified == other.modified && changed == other.changed
+           && inode == other.inode;
+}
+
+bool FileWatcher::FileStamp::operator!=(const FileStamp& other) const
+{
+    return !(*this == other);
+}
 
 FileWatcher::FileWatcher(QObject* parent)
     : QObject(parent)
@@ -42,32 +106,45 @@ void FileWatcher::start(const QString& filePath, int checksumIntervalSeconds, in
 {
     stop();
 
-#if defined(Q_OS_LINUX)
-    struct statfs statfsBuf;
-    bool forcePolling = false;
-    const auto NFS_SUPER_MAGIC = 0x6969;
-
-    if (!statfs(filePath.toLocal8Bit().constData(), &statfsBuf)) {
-        forcePolling = (statfsBuf.f_type == NFS_SUPER_MAGIC);
-    } else {
-        // if we can't get the fs type let's fall back to polling
-        forcePolling = true;
-    }
-    auto objectName = forcePolling ? QLatin1String("_qt_autotest_force_engine_poller") : QLatin1String("");
-    m_fileWatcher.setObjectName(objectName);
-#endif
-
-    m_fileWatcher.addPath(filePath);
     m_filePath = filePath;
 
     // Handle file checksum
     m_fileChecksumSizeBytes = checksumSizeKibibytes * 1024;
+    m_fileStamp = readFileStamp();
     m_fileChecksum = calculateChecksum();
+
+    m_ignoreFileChange = false;
+
+    if (isNetworkFileSystem(filePath)) {
+        startPolling(checksumIntervalSeconds);
+        return;
+    }
+
+    if (!startInotify()) {
+        m_fileWatcher.addPath(filePath);
+    }
+    // Notifications can be lost, e.g. on queue overflow or when the directory is replaced
     if (checksumIntervalSeconds > 0) {
         m_fileChecksumTimer.start(checksumIntervalSeconds * 1000);
     }
+}
 
-    m_ignoreFileChange = false;
+/**
+ * Changes made by other clients of a network file system are not notified, poll the file
+ * metadata instead.
+ */
+void FileWatcher::startPolling(int checksumIntervalSeconds)
+{
+    stopInotify();
+    m_fileWatcher.removePath(m_filePath);
+
+    m_polling = true;
+    m_maxPollIntervalMs = MaxPollIntervalMs;
+    if (checksumIntervalSeconds > 0) {
+        m_maxPollIntervalMs = qMax(static_cast<int>(MinPollIntervalMs), checksumIntervalSeconds * 1000);
+    }
+    m_pollIntervalMs = MinPollIntervalMs;
+    m_fileChecksumTimer.start(m_pollIntervalMs);
 }
 
 void FileWatcher::stop()
@@ -75,10 +152,13 @@ void FileWatcher::stop()
     if (!m_filePath.isEmpty()) {
         m_fileWatcher.removePath(m_filePath);
     }
+    stopInotify();
     m_filePath.clear();
     m_fileChecksum.clear();
+    m_fileStamp = {};
     m_fileChecksumTimer.stop();
     m_fileChangeDelayTimer.stop();
+    m_polling = false;
 }
 
 void FileWatcher::pause()
@@ -104,7 +184,20 @@ bool FileWatcher::shouldIgnoreChanges()
 
 bool FileWatcher::hasSameFileChecksum()
 {
-    return calculateChecksum() == m_fileChecksum;
+    // Unchanged metadata means unchanged contents, unless a check is still running, the
+    // metadata of a network file system may be cached or the file was written very recently
+    auto stamp = readFileStamp();
+    if (!m_polling && !m_ignoreFileChange && !m_fileChecksum.isEmpty() && stamp == m_fileStamp
+        && !m_fileStamp.isRacy()) {
+        return true;
+    }
+
+    bool same = calculateChecksum() == m_fileChecksum;
+    if (same && !m_ignoreFileChange && stamp == m_fileStamp) {
+        // The contents are confirmed for this stamp, later checks can trust it once it is old enough
+        m_fileStamp = stamp;
+    }
+    return same;
 }
 
 void FileWatcher::checkFileChanged()
@@ -113,21 +206,156 @@ void FileWatcher::checkFileChanged()
         return;
     }
 
+    // Only read the file if its metadata changed or cannot be trusted yet
+    auto stamp = readFileStamp();
+    if (stamp == m_fileStamp && !m_fileStamp.isRacy()) {
+        updatePollInterval(false);
+        return;
+    }
+    m_fileStamp = stamp;
+
     // Prevent reentrance
     m_ignoreFileChange = true;
 
     AsyncTask::runThenCallback([=] { return calculateChecksum(); },
                                this,
                                [=](QByteArray checksum) {
-                                   if (checksum != m_fileChecksum) {
+                                   bool changed = checksum != m_fileChecksum;
+                                   if (changed) {
                                        m_fileChecksum = checksum;
                                        m_fileChangeDelayTimer.start(0);
                                    }
+                                   updatePollInterval(changed);
 
                                    m_ignoreFileChange = false;
+
+                                   // Notifications are ignored while hashing, catch up on later writes
+                                   if (!changed && readFileStamp() != m_fileStamp) {
+                                       checkFileChanged();
+                                   }
                                });
 }
 
+/**
+ * Slow down polling while the file stays unchanged, return to the shortest interval on changes.
+ */
+void FileWatcher::updatePollInterval(bool changed)
+{
+    if (!m_polling) {
+        return;
+    }
+
+    auto interval = changed ? MinPollIntervalMs : qMin(m_pollIntervalMs * 2, m_maxPollIntervalMs);
+    if (interval != m_pollIntervalMs) {
+        m_pollIntervalMs = interval;
+        m_fileChecksumTimer.start(m_pollIntervalMs);
+    }
+}
+
+/**
+ * Watch the parent directory through inotify. Watching the directory instead of the file
+ * also catches the file being replaced, which is how atomic saves write it.
+ *
+ * @return false if inotify is not available
+ */
+bool FileWatcher::startInotify()
+{
+#ifdef Q_OS_LINUX
+    QFileInfo info(m_filePath);
+    QFileInfo target(info.exists() ? info.canonicalFilePath() : info.absoluteFilePath());
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        return false;
+    }
+
+    auto directory = QFile::encodeName(target.absolutePath());
+    const quint32 mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF;
+    if (inotify_add_watch(m_inotifyFd, directory.constData(), mask) < 0) {
+        stopInotify();
+        return false;
+    }
+
+    m_inotifyFileName = QFile::encodeName(target.fileName());
+    m_inotifyNotifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+    connect(m_inotifyNotifier, SIGNAL(activated(int)), SLOT(readInotifyEvents()));
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileWatcher::stopInotify()
+{
+    delete m_inotifyNotifier;
+    m_inotifyNotifier = nullptr;
+#ifdef Q_OS_LINUX
+    if (m_inotifyFd >= 0) {
+        close(m_inotifyFd);
+    }
+#endif
+    m_inotifyFd = -1;
+    m_inotifyFileName.clear();
+}
+
+void FileWatcher::readInotifyEvents()
+{
+#ifdef Q_OS_LINUX
+    bool changed = false;
+    alignas(struct inotify_event) char buffer[4096];
+    while (m_inotifyFd >= 0) {
+        auto length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        for (char* ptr = buffer; ptr < buffer + length;) {
+            const auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+            // Other files in the directory are ignored, events about the directory itself are not
+            if ((event->mask & (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_IGNORED))
+                || (event->len > 0 && m_inotifyFileName == event->name)) {
+                changed = true;
+            }
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    if (changed) {
+        checkFileChanged();
+    }
+#endif
+}
+
+/**
+ * Read the metadata that changes whenever the file is written or replaced.
+ */
+FileWatcher::FileStamp FileWatcher::readFileStamp() const
+{
+    FileStamp stamp;
+#ifdef Q_OS_LINUX
+    struct stat info;
+    if (stat(QFile::encodeName(m_filePath).constData(), &info) == 0) {
+        stamp.exists = true;
+        stamp.size = info.st_size;
+        stamp.modified = info.st_mtim.tv_sec * Q_INT64_C(1000000000) + info.st_mtim.tv_nsec;
+        stamp.changed = info.st_ctim.tv_sec * Q_INT64_C(1000000000) + info.st_ctim.tv_nsec;
+        stamp.inode = info.st_ino;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    stamp.read = now.tv_sec * Q_INT64_C(1000000000) + now.tv_nsec;
+#else
+    QFileInfo info(m_filePath);
+    if (info.exists()) {
+        stamp.exists = true;
+        stamp.size = info.size();
+        stamp.modified = info.lastModified().toMSecsSinceEpoch() * 1000000;
+        stamp.changed = info.metadataChangeTime().toMSecsSinceEpoch() * 1000000;
+    }
+    stamp.read = QDateTime::currentMSecsSinceEpoch() * 1000000;
+#endif
+    return stamp;
+}
+
 QByteArray FileWatcher::calculateChecksum()
 {
     QFile file(m_filePath);
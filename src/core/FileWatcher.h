@@ -21,6 +21,21 @@
 #include <QFileSystemWatcher>
 #include <QTimer>
 
+class QSocketNotifier;
+
+/**
+ * Watch a file for external changes.
+ *
+ * A change is only reported if the contents changed. The size, modification time and inode
+ * of the file are compared first, and the file is hashed only if one of them differs or the
+ * file was written too recently for its timestamps to tell writes apart.
+ *
+ * On Linux, files on local file systems are watched through inotify on the parent directory,
+ * which also catches files replaced by an atomic rename. Files on network file systems do not
+ * deliver notifications for remote changes and are polled at an adaptive interval instead.
+ * Other platforms use QFileSystemWatcher. Local files are also checked periodically in case a
+ * notification is lost.
+ */
 class FileWatcher : public QObject
 {
     Q_OBJECT
@@ -43,19 +58,55 @@ public slots:
 
 private slots:
     void checkFileChanged();
+    void readInotifyEvents();
 
 private:
+    struct FileStamp
+    {
+        bool exists = false;
+        qint64 size = 0;
+        qint64 modified = 0;
+        qint64 changed = 0;
+        quint64 inode = 0;
+        // When the stamp was read, not compared
+        qint64 read = 0;
+
+        bool isRacy() const;
+        bool operator==(const FileStamp& other) const;
+        bool operator!=(const FileStamp& other) const;
+    };
+
+    // Adaptive polling interval used for network file systems
+    static const int MinPollIntervalMs = 1000;
+    static const int MaxPollIntervalMs = 30000;
+
     QByteArray calculateChecksum();
+    FileStamp readFileStamp() const;
     bool shouldIgnoreChanges();
+    void startPolling(int checksumIntervalSeconds);
+    bool startInotify();
+    void stopInotify();
+    void updatePollInterval(bool changed);
 
     QString m_filePath;
     QFileSystemWatcher m_fileWatcher;
     QByteArray m_fileChecksum;
+    FileStamp m_fileStamp;
     QTimer m_fileChangeDelayTimer;
     QTimer m_fileIgnoreDelayTimer;
     QTimer m_fileChecksumTimer;
     int m_fileChecksumSizeBytes = -1;
     bool m_ignoreFileChange = false;
+
+    int m_inotifyFd = -1;
+    QByteArray m_inotifyFileName;
+    QSocketNotifier* m_inotifyNotifier = nullptr;
+
+    bool m_polling = false;
+    int m_pollIntervalMs = MinPollIntervalMs;
+    int m_maxPollIntervalMs = MaxPollIntervalMs;
+
+    friend class TestFileWatcher;
 };
 
 #endif // KEEPASSXC_FILEWATCHER_H
@@ -67,6 +67,10 @@ Group::~Group()
         delete group;
     }
 
+    if (m_db) {
+        m_db->removeFromUuidIndex(this, m_uuid);
+    }
+
     if (m_db && m_parent) {
         DeletedObject delGroup;
         delGroup.deletionTime = Clock::currentDateTimeUtc();
@@ -323,7 +327,11 @@ bool Group::equals(const Group* other, CompareItemOptions options) const
 
 void Group::setUuid(const QUuid& uuid)
 {
-    set(m_uuid, uuid);
+    QUuid oldUuid = m_uuid;
+    if (set(m_uuid, uuid) && m_db) {
+        m_db->removeFromUuidIndex(this, oldUuid);
+        m_db->addToUuidIndex(this);
+    }
 }
 
 void Group::setName(const QString& name)
@@ -570,20 +578,36 @@ const QList<Entry*>& Group::entries() const
 QList<Entry*> Group::entriesRecursive(bool includeHistoryItems) const
 {
     QList<Entry*> entryList;
+    forEachEntryRecursive([&entryList](Entry* entry) { entryList.append(entry); }, includeHistoryItems);
+    return entryList;
+}
 
-    entryList.append(m_entries);
+/**
+ * Visit all entries of this group and its subgroups without building intermediate lists.
+ * Entries are visited in the same order as returned by entriesRecursive().
+ *
+ * The tree must not be modified from within the callback.
+ *
+ * @param callback function called for every entry
+ * @param includeHistoryItems also visit the history items of every entry
+ */
+void Group::forEachEntryRecursive(const std::function<void(Entry*)>& callback, bool includeHistoryItems) const
+{
+    for (Entry* entry : m_entries) {
+        callback(entry);
+    }
 
     if (includeHistoryItems) {
-        for (Entry* entry : m_entries) {
-            entryList.append(entry->historyItems());
+        for (const Entry* entry : m_entries) {
+            for (Entry* historyItem : entry->historyItems()) {
+                callback(historyItem);
+            }
         }
     }
 
-    for (Group* group : m_children) {
-        entryList.append(group->entriesRecursive(includeHistoryItems));
+    for (const Group* group : m_children) {
+        group->forEachEntryRecursive(callback, includeHistoryItems);
     }
-
-    return entryList;
 }
 
 QList<Entry*> Group::referencesRecursive(const Entry* entry) const
@@ -599,6 +623,10 @@ Entry* Group::findEntryByUuid(const QUuid& uuid, bool recursive) const
         return nullptr;
     }
 
+    if (m_db) {
+        return m_db->findIndexedEntry(uuid, this, recursive);
+    }
+
     auto entries = m_entries;
     if (recursive) {
         entries = entriesRecursive(false);
@@ -634,6 +662,13 @@ Entry* Group::findEntryBySearchTerm(const QString& term, EntryReferenceType refe
                "Database::findEntryRecursive",
                "Can't search entry with \"referenceType\" parameter equal to \"Unknown\"");
 
+    if (m_db && referenceType != EntryReferenceType::CustomAttributes) {
+        if (referenceType == EntryReferenceType::QUuid) {
+            return findEntryByUuid(QUuid::fromRfc4122(QByteArray::fromHex(term.toLatin1())), true);
+        }
+        return m_db->findReferencedEntry(term, referenceType, this);
+    }
+
     const QList<Group*> groups = groupsRecursive(true);
 
     for (const Group* group : groups) {
@@ -773,29 +808,46 @@ QString Group::print(bool recursive, bool flatten, int depth)
 QList<const Group*> Group::groupsRecursive(bool includeSelf) const
 {
     QList<const Group*> groupList;
+    forEachGroupRecursive([&groupList](const Group* group) { groupList.append(group); }, includeSelf);
+    return groupList;
+}
+
+QList<Group*> Group::groupsRecursive(bool includeSelf)
+{
+    QList<Group*> groupList;
+    forEachGroupRecursive([&groupList](Group* group) { groupList.append(group); }, includeSelf);
+    return groupList;
+}
+
+/**
+ * Visit this group and all of its subgroups depth-first without building intermediate lists.
+ * Groups are visited in the same order as returned by groupsRecursive().
+ *
+ * The tree must not be modified from within the callback.
+ *
+ * @param callback function called for every group
+ * @param includeSelf also visit this group
+ */
+void Group::forEachGroupRecursive(const std::function<void(const Group*)>& callback, bool includeSelf) const
+{
     if (includeSelf) {
-        groupList.append(this);
+        callback(this);
     }
 
-    for (const Group* group : asConst(m_children)) {
-        groupList.append(group->groupsRecursive(true));
+    for (const Group* group : m_children) {
+        group->forEachGroupRecursive(callback, true);
     }
-
-    return groupList;
 }
 
-QList<Group*> Group::groupsRecursive(bool includeSelf)
+void Group::forEachGroupRecursive(const std::function<void(Group*)>& callback, bool includeSelf)
 {
-    QList<Group*> groupList;
     if (includeSelf) {
-        groupList.append(this);
+        callback(this);
     }
 
     for (Group* group : asConst(m_children)) {
-        groupList.append(group->groupsRecursive(true));
+        group->forEachGroupRecursive(callback, true);
     }
-
-    return groupList;
 }
 
 QSet<QUuid> Group::customIconsRecursive() const
@@ -862,6 +914,10 @@ Group* Group::findGroupByUuid(const QUuid& uuid)
         return nullptr;
     }
 
+    if (m_db) {
+        return m_db->findIndexedGroup(uuid, this);
+    }
+
     for (Group* group : groupsRecursive(true)) {
         if (group->uuid() == uuid) {
             return group;
@@ -877,6 +933,10 @@ const Group* Group::findGroupByUuid(const QUuid& uuid) const
         return nullptr;
     }
 
+    if (m_db) {
+        return m_db->findIndexedGroup(uuid, this);
+    }
+
     for (const Group* group : groupsRecursive(true)) {
         if (group->uuid() == uuid) {
             return group;
@@ -968,6 +1028,10 @@ void Group::addEntry(Entry* entry)
     connect(entry, &Entry::entryDataChanged, this, &Group::entryDataChanged);
     if (m_db) {
         connect(entry, &Entry::modified, m_db, &Database::markAsModified);
+        m_db->addToUuidIndex(entry);
+        m_db->addToReferenceIndex(entry);
+        m_db->addToUrlIndex(entry);
+        m_db->addToAutoTypeIndex(entry);
     }
 
     emitModified();
@@ -985,6 +1049,10 @@ void Group::removeEntry(Entry* entry)
     entry->disconnect(this);
     if (m_db) {
         entry->disconnect(m_db);
+        m_db->removeFromUuidIndex(entry, entry->uuid());
+        m_db->removeFromReferenceIndex(entry);
+        m_db->removeFromUrlIndex(entry);
+        m_db->removeFromAutoTypeIndex(entry);
     }
     m_entries.removeAll(entry);
     emitModified();
@@ -1019,16 +1087,36 @@ void Group::moveEntryDown(Entry* entry)
 
 void Group::connectDatabaseSignalsRecursive(Database* db)
 {
+    bool databaseChanged = (m_db != db);
+
     if (m_db) {
         disconnect(m_db);
+        if (databaseChanged) {
+            m_db->removeFromUuidIndex(this, m_uuid);
+        }
+    }
+    if (db && databaseChanged) {
+        db->addToUuidIndex(this);
     }
 
     for (Entry* entry : asConst(m_entries)) {
         if (m_db) {
             entry->disconnect(m_db);
+            if (databaseChanged) {
+                m_db->removeFromUuidIndex(entry, entry->uuid());
+                m_db->removeFromReferenceIndex(entry);
+                m_db->removeFromUrlIndex(entry);
+                m_db->removeFromAutoTypeIndex(entry);
+            }
         }
         if (db) {
             connect(entry, &Entry::modified, db, &Database::markAsModified);
+            if (databaseChanged) {
+                db->addToUuidIndex(entry);
+                db->addToReferenceIndex(entry);
+                db->addToUrlIndex(entry);
+                db->addToAutoTypeIndex(entry);
+            }
         }
     }
 
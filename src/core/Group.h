@@ -21,6 +21,8 @@
 
 #include <QPointer>
 
+#include <functional>
+
 #include "core/CustomData.h"
 #include "core/Database.h"
 #include "core/Entry.h"
@@ -158,6 +160,9 @@ public:
     QList<Entry*> entriesRecursive(bool includeHistoryItems = false) const;
     QList<const Group*> groupsRecursive(bool includeSelf) const;
     QList<Group*> groupsRecursive(bool includeSelf);
+    void forEachEntryRecursive(const std::function<void(Entry*)>& callback, bool includeHistoryItems = false) const;
+    void forEachGroupRecursive(const std::function<void(const Group*)>& callback, bool includeSelf = true) const;
+    void forEachGroupRecursive(const std::function<void(Group*)>& callback, bool includeSelf = true);
     QSet<QUuid> customIconsRecursive() const;
     QList<QString> usernamesRecursive(int topN = -1) const;
 
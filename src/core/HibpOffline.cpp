@@ -20,12 +20,26 @@
 #include "core/Group.h"
 
 #include <QCryptographicHash>
+#include <QFile>
 #include <QProcess>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 namespace HibpOffline
 {
     const std::size_t SHA1_BYTES = 20;
 
+    // Binary index: header followed by records of SHA-1 and big endian count, sorted by SHA-1
+    const char INDEX_MAGIC[] = "KPXCHIBP";
+    const qint64 INDEX_MAGIC_SIZE = 8;
+    const quint32 INDEX_VERSION = 1;
+    const qint64 INDEX_HEADER_SIZE = INDEX_MAGIC_SIZE + 8;
+    const qint64 INDEX_RECORD_SIZE = SHA1_BYTES + 4;
+
     enum class ParseResult
     {
         Ok,
@@ -33,6 +47,13 @@ namespace HibpOffline
         Error
     };
 
+    enum class SearchResult
+    {
+        Found,
+        NotFound,
+        Unordered
+    };
+
     ParseResult parseHibpLine(QIODevice& input, QByteArray& sha1, int& count)
     {
         QByteArray hexSha1(SHA1_BYTES * 2, '\0');
@@ -75,16 +96,132 @@ namespace HibpOffline
         return ParseResult::Ok;
     }
 
-    bool
-    report(QSharedPointer<Database> db, QIODevice& hibpInput, QList<QPair<const Entry*, int>>& findings, QString* error)
+    int hexValue(char c)
+    {
+        if ('0' <= c && c <= '9') {
+            return c - '0';
+        }
+        if ('a' <= c && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if ('A' <= c && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    /**
+     * Parse the line of a memory mapped HIBP file starting at pos.
+     *
+     * @param next set to the start of the following line
+     * @return false on a malformed line
+     */
+    bool parseMappedLine(const char* data, qint64 size, qint64 pos, QByteArray& sha1, int& count, qint64& next)
+    {
+        if (size - pos < static_cast<qint64>(SHA1_BYTES * 2 + 2)) {
+            return false;
+        }
+
+        sha1.resize(SHA1_BYTES);
+        for (std::size_t i = 0; i < SHA1_BYTES; ++i) {
+            const int high = hexValue(data[pos++]);
+            const int low = hexValue(data[pos++]);
+            if (high < 0 || low < 0) {
+                return false;
+            }
+            sha1[static_cast<int>(i)] = static_cast<char>(high << 4 | low);
+        }
+
+        if (data[pos++] != ':') {
+            return false;
+        }
+
+        count = 0;
+        const qint64 digitsStart = pos;
+        while (pos < size && '0' <= data[pos] && data[pos] <= '9') {
+            count *= 10;
+            count += (data[pos++] - '0');
+        }
+        if (pos == digitsStart || (pos < size && data[pos] != '\n' && data[pos] != '\r')) {
+            return false;
+        }
+
+        while (pos < size && (data[pos] == '\n' || data[pos] == '\r')) {
+            ++pos;
+        }
+        next = pos;
+        return true;
+    }
+
+    bool isIndex(const char* data, qint64 size)
+    {
+        return size >= INDEX_MAGIC_SIZE && memcmp(data, INDEX_MAGIC, INDEX_MAGIC_SIZE) == 0;
+    }
+
+    bool isValidIndex(const char* data, qint64 size)
+    {
+        return size >= INDEX_HEADER_SIZE && (size - INDEX_HEADER_SIZE) % INDEX_RECORD_SIZE == 0
+               && qFromBigEndian<quint32>(data + INDEX_MAGIC_SIZE) == INDEX_VERSION;
+    }
+
+    int recordCount(const char* record)
+    {
+        return static_cast<int>(
+            qMin<quint32>(qFromBigEndian<quint32>(record + SHA1_BYTES), std::numeric_limits<int>::max()));
+    }
+
+    /**
+     * Look up a hash in a binary index by bisection.
+     *
+     * Every record looked at has to lie between the records that bounded the search so far.
+     * Anything else means the index is not sorted, and a bisection could miss hashes.
+     */
+    SearchResult searchIndex(const char* data, qint64 size, const QByteArray& sha1, int& count)
+    {
+        const char* records = data + INDEX_HEADER_SIZE;
+        const char* lowerBound = nullptr;
+        const char* upperBound = nullptr;
+        qint64 lo = 0;
+        qint64 hi = (size - INDEX_HEADER_SIZE) / INDEX_RECORD_SIZE;
+        while (lo < hi) {
+            const qint64 mid = lo + (hi - lo) / 2;
+            const char* record = records + mid * INDEX_RECORD_SIZE;
+            if ((lowerBound && memcmp(lowerBound, record, SHA1_BYTES) >= 0)
+                || (upperBound && memcmp(record, upperBound, SHA1_BYTES) >= 0)) {
+                return SearchResult::Unordered;
+            }
+            const int cmp = memcmp(record, sha1.constData(), SHA1_BYTES);
+            if (cmp == 0) {
+                count = recordCount(record);
+                return SearchResult::Found;
+            }
+            if (cmp < 0) {
+                lo = mid + 1;
+                lowerBound = record;
+            } else {
+                hi = mid;
+                upperBound = record;
+            }
+        }
+        return SearchResult::NotFound;
+    }
+
+    QMultiHash<QByteArray, const Entry*> passwordHashes(const QSharedPointer<Database>& db)
     {
         QMultiHash<QByteArray, const Entry*> entriesBySha1;
-        for (const auto* entry : db->rootGroup()->entriesRecursive()) {
+        db->rootGroup()->forEachEntryRecursive([&entriesBySha1](const Entry* entry) {
             if (!entry->isRecycled()) {
                 const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
                 entriesBySha1.insert(sha1, entry);
             }
-        }
+        });
+        return entriesBySha1;
+    }
+
+    bool
+    report(QSharedPointer<Database> db, QIODevice& hibpInput, QList<QPair<const Entry*, int>>& findings, QString* error)
+    {
+        const auto entriesBySha1 = passwordHashes(db);
 
         QByteArray sha1;
         for (quint64 lineNum = 1;; ++lineNum) {
@@ -106,6 +243,167 @@ namespace HibpOffline
         }
     }
 
+    /**
+     * Scan a memory mapped HIBP text file line by line.
+     */
+    bool reportMapped(const QMultiHash<QByteArray, const Entry*>& entriesBySha1,
+                      const char* data,
+                      qint64 size,
+                      QList<QPair<const Entry*, int>>& findings,
+                      QString* error)
+    {
+        QByteArray sha1;
+        qint64 pos = 0;
+        for (quint64 lineNum = 1; pos < size; ++lineNum) {
+            int count = 0;
+            if (!parseMappedLine(data, size, pos, sha1, count, pos)) {
+                *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
+                return false;
+            }
+            for (const auto* entry : entriesBySha1.values(sha1)) {
+                findings.append({entry, count});
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Scan all records of a binary index, used if the index turns out not to be sorted.
+     */
+    void reportIndexRecords(const QMultiHash<QByteArray, const Entry*>& entriesBySha1,
+                            const char* data,
+                            qint64 size,
+                            QList<QPair<const Entry*, int>>& findings)
+    {
+        for (qint64 pos = INDEX_HEADER_SIZE; pos < size; pos += INDEX_RECORD_SIZE) {
+            const auto sha1 = QByteArray::fromRawData(data + pos, SHA1_BYTES);
+            for (const auto* entry : entriesBySha1.values(sha1)) {
+                findings.append({entry, recordCount(data + pos)});
+            }
+        }
+    }
+
+    /**
+     * Check the passwords of a database against a HIBP file on disk.
+     *
+     * Binary indexes created with buildIndex() are memory mapped and searched by bisection.
+     * Their order was verified over the whole file when they were built. Text files are
+     * scanned line by line, whatever order they claim to have.
+     */
+    bool report(QSharedPointer<Database> db,
+                const QString& hibpFilePath,
+                QList<QPair<const Entry*, int>>& findings,
+                QString* error)
+    {
+        QFile hibpFile(hibpFilePath);
+        if (!hibpFile.open(QFile::ReadOnly)) {
+            *error = QObject::tr("Failed to open HIBP file %1: %2").arg(hibpFilePath, hibpFile.errorString());
+            return false;
+        }
+
+        const qint64 size = hibpFile.size();
+        const auto data = reinterpret_cast<const char*>(size > 0 ? hibpFile.map(0, size) : nullptr);
+        if (!data) {
+            return report(db, hibpFile, findings, error);
+        }
+
+        const auto entriesBySha1 = passwordHashes(db);
+        if (!isIndex(data, size)) {
+            return reportMapped(entriesBySha1, data, size, findings, error);
+        }
+
+        if (!isValidIndex(data, size)) {
+            *error = QObject::tr("HIBP index file is invalid: %1").arg(hibpFilePath);
+            return false;
+        }
+
+        // Report findings in the order of the file, like a full scan would
+        auto hashes = entriesBySha1.uniqueKeys();
+        std::sort(hashes.begin(), hashes.end());
+
+        QList<QPair<const Entry*, int>> indexFindings;
+        for (const auto& sha1 : asConst(hashes)) {
+            int count = 0;
+            const auto result = searchIndex(data, size, sha1, count);
+            if (result == SearchResult::Unordered) {
+                qWarning("HIBP index file is not sorted, scanning it instead: %s", qPrintable(hibpFilePath));
+                reportIndexRecords(entriesBySha1, data, size, findings);
+                return true;
+            }
+            if (result == SearchResult::Found) {
+                for (const auto* entry : entriesBySha1.values(sha1)) {
+                    indexFindings.append({entry, count});
+                }
+            }
+        }
+
+        findings.append(indexFindings);
+        return true;
+    }
+
+    /**
+     * Convert a HIBP text file sorted by hash into a compact binary index,
+     * which is a third of the size and faster to search.
+     */
+    bool buildIndex(const QString& hibpFilePath, const QString& indexFilePath, QString* error)
+    {
+        QFile hibpFile(hibpFilePath);
+        if (!hibpFile.open(QFile::ReadOnly)) {
+            *error = QObject::tr("Failed to open HIBP file %1: %2").arg(hibpFilePath, hibpFile.errorString());
+            return false;
+        }
+
+        const qint64 size = hibpFile.size();
+        const auto data = reinterpret_cast<const char*>(size > 0 ? hibpFile.map(0, size) : nullptr);
+        if (!data) {
+            *error = QObject::tr("Failed to read HIBP file %1: %2").arg(hibpFilePath, hibpFile.errorString());
+            return false;
+        }
+
+        QSaveFile indexFile(indexFilePath);
+        if (!indexFile.open(QIODevice::WriteOnly)) {
+            *error = QObject::tr("Failed to open HIBP index file %1: %2").arg(indexFilePath, indexFile.errorString());
+            return false;
+        }
+
+        QByteArray header(INDEX_HEADER_SIZE, '\0');
+        memcpy(header.data(), INDEX_MAGIC, INDEX_MAGIC_SIZE);
+        qToBigEndian<quint32>(INDEX_VERSION, header.data() + INDEX_MAGIC_SIZE);
+        indexFile.write(header);
+
+        QByteArray sha1;
+        QByteArray previous;
+        QByteArray record(INDEX_RECORD_SIZE, '\0');
+        qint64 pos = 0;
+        for (quint64 lineNum = 1; pos < size; ++lineNum) {
+            int count = 0;
+            if (!parseMappedLine(data, size, pos, sha1, count, pos)) {
+                *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
+                return false;
+            }
+            if (!previous.isEmpty() && sha1 <= previous) {
+                *error = QObject::tr("HIBP file, line %1: file is not ordered by hash").arg(lineNum);
+                return false;
+            }
+            previous = sha1;
+
+            memcpy(record.data(), sha1.constData(), SHA1_BYTES);
+            qToBigEndian<quint32>(static_cast<quint32>(count), record.data() + SHA1_BYTES);
+            if (indexFile.write(record) != record.size()) {
+                *error = QObject::tr("Failed to write HIBP index file %1: %2")
+                             .arg(indexFilePath, indexFile.errorString());
+                return false;
+            }
+        }
+
+        if (!indexFile.commit()) {
+            *error =
+                QObject::tr("Failed to write HIBP index file %1: %2").arg(indexFilePath, indexFile.errorString());
+            return false;
+        }
+        return true;
+    }
+
     bool okonReport(QSharedPointer<Database> db,
                     const QString& okon,
                     const QString& okonDatabase,
@@ -32,6 +32,13 @@ namespace HibpOffline
                 QList<QPair<const Entry*, int>>& findings,
                 QString* error);
 
+    bool report(QSharedPointer<Database> db,
+                const QString& hibpFilePath,
+                QList<QPair<const Entry*, int>>& findings,
+                QString* error);
+
+    bool buildIndex(const QString& hibpFilePath, const QString& indexFilePath, QString* error);
+
     bool okonReport(QSharedPointer<Database> db,
                     const QString& okon,
                     const QString& okonDatabase,
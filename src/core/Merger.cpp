@@ -19,6 +19,8 @@
 
 #include "core/Metadata.h"
 
+#include <QCryptographicHash>
+
 Merger::Merger(const Database* sourceDb, Database* targetDb)
     : m_mode(Group::Default)
 {
@@ -93,6 +95,11 @@ Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
                 changes << tr("Relocating %1 [%2]").arg(sourceEntry->title(), sourceEntry->uuidToHex());
                 moveEntry(targetEntry, context.m_targetGroup);
             }
+            const QByteArray fingerprint = entryFingerprint(sourceEntry);
+            if (!fingerprint.isEmpty() && fingerprint == entryFingerprint(targetEntry)) {
+                // Same revision with the same history on both sides, nothing to resolve
+                continue;
+            }
             changes << resolveEntryConflict(context, sourceEntry, targetEntry);
         }
     }
@@ -463,19 +470,27 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
         eraseEntry(entry);
     }
 
-    while (!groups.isEmpty()) {
-        auto* group = groups.takeFirst();
-        if (!(group->children().toSet() & groups.toSet()).isEmpty()) {
-            // we need to finish all children before we are able to determine if the group can be removed
-            groups << group;
-            continue;
+    // Children have to be finished before we are able to determine if their parent can be removed,
+    // so handle the deepest groups first and decide on every group in a single pass
+    QHash<const Group*, int> depths;
+    for (const Group* group : asConst(groups)) {
+        int depth = 0;
+        for (const Group* parent = group->parentGroup(); parent; parent = parent->parentGroup()) {
+            ++depth;
         }
+        depths.insert(group, depth);
+    }
+    std::stable_sort(groups.begin(), groups.end(), [&depths](const Group* lhs, const Group* rhs) {
+        return depths.value(lhs) > depths.value(rhs);
+    });
+
+    for (auto* group : asConst(groups)) {
         const auto& object = mergedDeletions[group->uuid()];
         if (group->timeInfo().lastModificationTime() > object.deletionTime) {
             // keep deleted group since it was changed after deletion date
             continue;
         }
-        if (!group->entriesRecursive(false).isEmpty() || !group->groupsRecursive(false).isEmpty()) {
+        if (!group->entries().isEmpty() || !group->children().isEmpty()) {
             // keep deleted group since it contains undeleted content
             continue;
         }
@@ -495,6 +510,62 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
     return changes;
 }
 
+/**
+ * Digest of everything the conflict resolution looks at: the modification times of the
+ * entry and all of its history items and the content of the current revision.
+ *
+ * Two entries with the same fingerprint merge into each other without any change, which
+ * allows skipping the history merge (and the cloning it involves) for unchanged entries.
+ *
+ * @return fingerprint or an empty array if the history is not in a canonical order
+ */
+QByteArray Merger::entryFingerprint(const Entry* entry)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    auto addTime = [&hash](const QDateTime& dateTime) {
+        const qint64 secs = dateTime.toSecsSinceEpoch();
+        hash.addData(reinterpret_cast<const char*>(&secs), sizeof(secs));
+    };
+    auto addString = [&hash](const QString& string) {
+        hash.addData(string.toUtf8());
+        hash.addData("\0", 1);
+    };
+
+    // Merging rewrites the history whenever it is unsorted or contains duplicate times
+    QDateTime previousTime;
+    for (const Entry* historyItem : entry->historyItems()) {
+        const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
+        if (previousTime.isValid() && previousTime >= modificationTime) {
+            return {};
+        }
+        previousTime = modificationTime;
+        addTime(modificationTime);
+    }
+    addString(QString::number(entry->historyItems().size()));
+    addTime(entry->timeInfo().lastModificationTime());
+
+    // Conflicting content at the same time is only reported by the merge, keep reporting it
+    const EntryAttributes* attributes = entry->attributes();
+    for (const QString& key : attributes->keys()) {
+        addString(key);
+        addString(attributes->value(key));
+    }
+    const EntryAttachments* attachments = entry->attachments();
+    for (const QString& key : attachments->keys()) {
+        addString(key);
+        hash.addData(QCryptographicHash::hash(attachments->value(key), QCryptographicHash::Md5));
+    }
+    const CustomData* customData = entry->customData();
+    for (const QString& key : customData->keys()) {
+        addString(key);
+        addString(customData->value(key));
+    }
+    addString(entry->tags());
+    addString(entry->iconUuid().toString());
+    addString(QString::number(entry->iconNumber()));
+    return hash.result();
+}
+
 Merger::ChangeList Merger::mergeMetadata(const MergeContext& context)
 {
     // TODO HNH: missing handling of recycle bin, names, templates for groups and entries,
@@ -62,6 +62,7 @@ private:
                                                            const Entry* sourceEntry,
                                                            Entry* targetEntry,
                                                            Group::MergeMode mergeMethod);
+    static QByteArray entryFingerprint(const Entry* entry);
 
 private:
     MergeContext m_context;
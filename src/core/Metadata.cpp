@@ -26,6 +26,8 @@
 #include <QCryptographicHash>
 #include <QJsonDocument>
 
+#include <atomic>
+
 const int Metadata::DefaultHistoryMaxItems = 10;
 const int Metadata::DefaultHistoryMaxSize = 6 * 1024 * 1024;
 const int Metadata::DefaultAutosaveDelayMin = 0;
@@ -33,6 +35,9 @@ const int Metadata::DefaultAutosaveDelayMin = 0;
 // Fallback icon for return by reference
 static const Metadata::CustomIconData NULL_ICON{};
 
+// Source of cache keys which are unique across all databases
+static std::atomic<quint64> s_nextCustomIconCacheKey{1};
+
 namespace customDataKeys
 {
     static const QString savedSearch = QStringLiteral("KPXC_SavedSearch");
@@ -79,6 +84,7 @@ void Metadata::clear()
     m_customIcons.clear();
     m_customIconsOrder.clear();
     m_customIconsHashes.clear();
+    m_customIconsCacheKeys.clear();
     m_customData->clear();
 }
 
@@ -117,6 +123,32 @@ void Metadata::copyAttributesFrom(const Metadata* other)
     m_data = other->m_data;
 }
 
+void Metadata::copyFrom(const Metadata* other, Group* rootGroup)
+{
+    auto resolveGroup = [rootGroup](const Group* group) -> Group* {
+        return group ? rootGroup->findGroupByUuid(group->uuid()) : nullptr;
+    };
+
+    m_data = other->m_data;
+
+    m_customIconsOrder = other->m_customIconsOrder;
+    m_customIcons = other->m_customIcons;
+    m_customIconsHashes = other->m_customIconsHashes;
+    m_customIconsCacheKeys = other->m_customIconsCacheKeys;
+
+    m_recycleBin = resolveGroup(other->m_recycleBin);
+    m_recycleBinChanged = other->m_recycleBinChanged;
+    m_entryTemplatesGroup = resolveGroup(other->m_entryTemplatesGroup);
+    m_entryTemplatesGroupChanged = other->m_entryTemplatesGroupChanged;
+    m_lastSelectedGroup = resolveGroup(other->m_lastSelectedGroup);
+    m_lastTopVisibleGroup = resolveGroup(other->m_lastTopVisibleGroup);
+
+    m_masterKeyChanged = other->m_masterKeyChanged;
+    m_settingsChanged = other->m_settingsChanged;
+
+    m_customData->copyDataFrom(other->m_customData);
+}
+
 QString Metadata::generator() const
 {
     return m_data.generator;
@@ -207,6 +239,18 @@ QList<QUuid> Metadata::customIconsOrder() const
     return m_customIconsOrder;
 }
 
+/**
+ * Key identifying the current image data of a custom icon, for caching data derived from it.
+ * Every time an icon is added it gets a new key, so cached data of removed or replaced
+ * icons is never used again.
+ *
+ * @return cache key or 0 if there is no such icon
+ */
+quint64 Metadata::customIconCacheKey(const QUuid& uuid) const
+{
+    return m_customIconsCacheKeys.value(uuid);
+}
+
 bool Metadata::recycleBinEnabled() const
 {
     return m_data.recycleBinEnabled;
@@ -382,6 +426,7 @@ void Metadata::addCustomIcon(const QUuid& uuid, const CustomIconData& iconData)
     // Associate image hash to uuid
     QByteArray hash = hashIcon(iconData.data);
     m_customIconsHashes[hash] = uuid;
+    m_customIconsCacheKeys[uuid] = s_nextCustomIconCacheKey++;
     Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
 
     emitModified();
@@ -408,6 +453,7 @@ void Metadata::removeCustomIcon(const QUuid& uuid)
 
     m_customIcons.remove(uuid);
     m_customIconsOrder.removeAll(uuid);
+    m_customIconsCacheKeys.remove(uuid);
     Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
     dynamic_cast<Database*>(parent())->addDeletedObject(uuid);
     emitModified();
@@ -96,6 +96,7 @@ public:
     const CustomIconData& customIcon(const QUuid& uuid) const;
     bool hasCustomIcon(const QUuid& uuid) const;
     QList<QUuid> customIconsOrder() const;
+    quint64 customIconCacheKey(const QUuid& uuid) const;
     bool recycleBinEnabled() const;
     Group* recycleBin();
     const Group* recycleBin() const;
@@ -166,6 +167,11 @@ public:
      * - Settings changed date
      */
     void copyAttributesFrom(const Metadata* other);
+    /*
+     * Copy everything from other, group pointers are resolved
+     * by uuid in the group tree below rootGroup
+     */
+    void copyFrom(const Metadata* other, Group* rootGroup);
 
 private:
     template <class P, class V> bool set(P& property, const V& value);
@@ -178,6 +184,7 @@ private:
     QList<QUuid> m_customIconsOrder;
     QHash<QUuid, CustomIconData> m_customIcons;
     QHash<QByteArray, QUuid> m_customIconsHashes;
+    QHash<QUuid, quint64> m_customIconsCacheKeys;
 
     QPointer<Group> m_recycleBin;
     QDateTime m_recycleBinChanged;
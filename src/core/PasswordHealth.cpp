@@ -15,15 +15,38 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QCryptographicHash>
+#include <QReadWriteLock>
 #include <QString>
+#include <QtConcurrent>
 
 #include "Group.h"
 #include "PasswordHealth.h"
+#include "crypto/Random.h"
 #include "zxcvbn.h"
 
 namespace
 {
     const static int ZXCVBN_ESTIMATE_THRESHOLD = 256;
+    // Upper bound of remembered estimates, the cache starts over once it is reached
+    const static int ENTROPY_CACHE_MAX_SIZE = 100000;
+
+    QReadWriteLock entropyCacheLock;
+    QHash<QByteArray, double> entropyCache;
+
+    /**
+     * Cache key of a password. The salt is random per session so that the
+     * cache does not hold plain hashes of the passwords.
+     */
+    QByteArray entropyCacheKey(const QString& pwd)
+    {
+        static const QByteArray salt = randomGen()->randomArray(32);
+
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+        hash.addData(salt);
+        hash.addData(pwd.toUtf8());
+        return hash.result();
+    }
 } // namespace
 
 PasswordHealth::PasswordHealth(double entropy)
@@ -32,6 +55,11 @@ PasswordHealth::PasswordHealth(double entropy)
 }
 
 PasswordHealth::PasswordHealth(const QString& pwd)
+{
+    init(estimateEntropy(pwd));
+}
+
+double PasswordHealth::estimateEntropy(const QString& pwd)
 {
     auto entropy = 0.0;
     entropy += ZxcvbnMatch(pwd.left(ZXCVBN_ESTIMATE_THRESHOLD).toUtf8(), nullptr, nullptr);
@@ -40,7 +68,32 @@ PasswordHealth::PasswordHealth(const QString& pwd)
         auto average = entropy / ZXCVBN_ESTIMATE_THRESHOLD;
         entropy += average * (pwd.length() - ZXCVBN_ESTIMATE_THRESHOLD);
     }
-    init(entropy);
+    return entropy;
+}
+
+/**
+ * Same as estimateEntropy(), but remembers the result for the rest of the session.
+ * Safe to call from multiple threads.
+ */
+double PasswordHealth::cachedEntropy(const QString& pwd)
+{
+    const auto key = entropyCacheKey(pwd);
+    {
+        QReadLocker locker(&entropyCacheLock);
+        auto it = entropyCache.constFind(key);
+        if (it != entropyCache.constEnd()) {
+            return it.value();
+        }
+    }
+
+    const auto entropy = estimateEntropy(pwd);
+
+    QWriteLocker locker(&entropyCacheLock);
+    if (entropyCache.size() >= ENTROPY_CACHE_MAX_SIZE) {
+        entropyCache.clear();
+    }
+    entropyCache.insert(key, entropy);
+    return entropy;
 }
 
 void PasswordHealth::init(double entropy)
@@ -139,7 +192,7 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
 
     // First analyse the password itself
     const auto pwd = entry->password();
-    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(pwd));
+    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(PasswordHealth::cachedEntropy(pwd)));
 
     // Second, if the password is in the database more than once,
     // reduce the score accordingly
@@ -201,3 +254,14 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
     // Return the result
     return health;
 }
+
+/**
+ * Evaluate the health of many entries at once, spread over the global thread pool.
+ *
+ * @return health of each entry, in the order of `entries`
+ */
+QList<QSharedPointer<PasswordHealth>> HealthChecker::evaluate(const QList<const Entry*>& entries) const
+{
+    return QtConcurrent::blockingMapped<QList<QSharedPointer<PasswordHealth>>>(
+        entries, [this](const Entry* entry) { return evaluate(entry); });
+}
@@ -19,6 +19,7 @@
 #define KEEPASSX_PASSWORDHEALTH_H
 
 #include <QHash>
+#include <QList>
 #include <QSharedPointer>
 
 class Database;
@@ -37,6 +38,9 @@ public:
 
     void init(double entropy);
 
+    static double estimateEntropy(const QString& pwd);
+    static double cachedEntropy(const QString& pwd);
+
     /*
      * The password score is defined to be the greater the better
      * (more secure) the password is. It doesn't have a dimension,
@@ -109,6 +113,7 @@ public:
 
     // Get the health status of an entry in the database
     QSharedPointer<PasswordHealth> evaluate(const Entry* entry) const;
+    QList<QSharedPointer<PasswordHealth>> evaluate(const QList<const Entry*>& entries) const;
 
 private:
     // To determine password re-use: first = password, second = entries that use it
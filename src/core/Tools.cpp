@@ -29,6 +29,8 @@
 #include "core/Clock.h"
 
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
 #include <QElapsedTimer>
 #include <QEventLoop>
 #include <QFileInfo>
@@ -39,6 +41,7 @@
 #include <QStringList>
 #include <QUrl>
 #include <QUuid>
+#include <algorithm>
 #include <cmath>
 
 #ifdef Q_OS_WIN
@@ -472,4 +475,203 @@ namespace Tools
 
         return pattern;
     }
+
+    namespace
+    {
+        const QString DefaultBackupTimeFormat = QStringLiteral("dd_MM_yyyy_hh-mm-ss");
+
+        /**
+         * Regular expression matching the text QDateTime::toString() produces for a format.
+         */
+        QString timeFormatToRegex(const QString& format)
+        {
+            QString regex;
+            int i = 0;
+            while (i < format.size()) {
+                const QChar c = format.at(i);
+
+                // Quoted text is literal, two quotes stand for one
+                if (c == '\'') {
+                    if (i + 1 < format.size() && format.at(i + 1) == '\'') {
+                        regex += "'";
+                        i += 2;
+                        continue;
+                    }
+                    int end = format.indexOf('\'', i + 1);
+                    if (end < 0) {
+                        end = format.size();
+                    }
+                    regex += QRegularExpression::escape(format.mid(i + 1, end - i - 1));
+                    i = end + 1;
+                    continue;
+                }
+
+                if ((c == 'a' || c == 'A') && i + 1 < format.size()
+                    && (format.at(i + 1) == 'p' || format.at(i + 1) == 'P')) {
+                    regex += "[AaPp][Mm]";
+                    i += 2;
+                    continue;
+                }
+
+                int count = 1;
+                while (i + count < format.size() && format.at(i + count) == c) {
+                    ++count;
+                }
+                i += count;
+
+                switch (c.unicode()) {
+                case 'd':
+                case 'M':
+                    regex += count == 1 ? "\\d{1,2}" : count == 2 ? "\\d{2}" : "\\w+";
+                    break;
+                case 'y':
+                    regex += count >= 4 ? "\\d{4}" : count >= 2 ? "\\d{2}" : "y";
+                    break;
+                case 'h':
+                case 'H':
+                case 'm':
+                case 's':
+                    regex += count == 1 ? "\\d{1,2}" : "\\d{2}";
+                    break;
+                case 'z':
+                    regex += count == 1 ? "\\d{1,3}" : "\\d{3}";
+                    break;
+                case 'a':
+                case 'A':
+                    regex += "[AaPp][Mm]";
+                    break;
+                case 't':
+                    regex += "\\S+";
+                    break;
+                default:
+                    regex += QRegularExpression::escape(QString(count, c));
+                }
+            }
+            return regex;
+        }
+
+        /**
+         * Position where the file name starts in a backup file path pattern.
+         * Backslashes escaping braces are not path separators.
+         */
+        int backupFileNameStart(const QString& pattern)
+        {
+            for (int i = pattern.size() - 1; i >= 0; --i) {
+                if (pattern.at(i) == '/') {
+                    return i + 1;
+                }
+#ifdef Q_OS_WIN
+                if (pattern.at(i) == '\\'
+                    && (i + 1 >= pattern.size() || (pattern.at(i + 1) != '{' && pattern.at(i + 1) != '}'))) {
+                    return i + 1;
+                }
+#endif
+            }
+            return 0;
+        }
+
+        QString unescapeBraces(QString text)
+        {
+            text.replace("\\{", "{");
+            text.replace("\\}", "}");
+            return text;
+        }
+    } // namespace
+
+    /**
+     * Delete the oldest backups created from a backup file path pattern so that at most
+     * maxBackups of them remain.
+     *
+     * Only patterns with {TIME} placeholders in the file name produce multiple backups.
+     * A file counts as a backup only if its whole name matches the pattern and every
+     * timestamp in it parses with the format of its placeholder. Backups are ordered by
+     * the first timestamp in their name, not by modification time.
+     *
+     * @param pattern backup file path pattern, relative paths are relative to the database
+     * @param databasePath path of the database the backups were created for
+     * @param maxBackups number of backups to keep, 0 keeps all of them
+     * @return paths of the deleted backups
+     */
+    QStringList pruneBackupFiles(QString pattern, const QString& databasePath, int maxBackups)
+    {
+        if (databasePath.isEmpty() || maxBackups <= 0) {
+            return {};
+        }
+
+        QFileInfo dbFileInfo(databasePath);
+        pattern.replace(QString("{DB_FILENAME}"), dbFileInfo.completeBaseName());
+
+        const int nameStart = backupFileNameStart(pattern);
+        static const QRegularExpression timeRegex(R"(\{TIME(?::([^\\]*))?\})");
+
+        // Build an anchored expression for the file name, capturing every timestamp
+        QString nameRegex;
+        QStringList timeFormats;
+        int literalStart = nameStart;
+        auto matches = timeRegex.globalMatch(pattern);
+        while (matches.hasNext()) {
+            const auto match = matches.next();
+            if (match.capturedStart() < nameStart) {
+                // Timestamped directories are not rotated
+                return {};
+            }
+            nameRegex += QRegularExpression::escape(
+                unescapeBraces(pattern.mid(literalStart, match.capturedStart() - literalStart)));
+            const auto format = match.captured(1).isEmpty() ? DefaultBackupTimeFormat : match.captured(1);
+            nameRegex += "(" + timeFormatToRegex(format) + ")";
+            timeFormats << format;
+            literalStart = match.capturedEnd();
+        }
+        if (timeFormats.isEmpty()) {
+            return {};
+        }
+        nameRegex += QRegularExpression::escape(unescapeBraces(pattern.mid(literalStart)));
+        const QRegularExpression backupName("^" + nameRegex + "$");
+
+        QString backupPath = unescapeBraces(pattern.left(nameStart));
+        if (QDir::isRelativePath(backupPath)) {
+            backupPath = dbFileInfo.absolutePath() + QDir::separator() + backupPath;
+        }
+
+        QList<QPair<QDateTime, QFileInfo>> backups;
+        const auto files = QDir(backupPath).entryInfoList(QDir::Files);
+        for (const auto& file : files) {
+            const auto match = backupName.match(file.fileName());
+            if (!match.hasMatch()) {
+                continue;
+            }
+
+            QDateTime timestamp;
+            bool valid = true;
+            for (int i = 0; i < timeFormats.size() && valid; ++i) {
+                const auto time = QDateTime::fromString(match.captured(i + 1), timeFormats[i]);
+                valid = time.isValid();
+                if (i == 0) {
+                    timestamp = time;
+                }
+            }
+
+            // Never delete the database itself if the pattern happens to match it
+            if (valid && file.canonicalFilePath() != dbFileInfo.canonicalFilePath()) {
+                backups.append({timestamp, file});
+            }
+        }
+
+        // Newest first, equal timestamps by name
+        std::sort(backups.begin(), backups.end(), [](const auto& left, const auto& right) {
+            if (left.first != right.first) {
+                return left.first > right.first;
+            }
+            return left.second.fileName() > right.second.fileName();
+        });
+
+        QStringList removed;
+        for (int i = maxBackups; i < backups.size(); ++i) {
+            const auto path = backups[i].second.absoluteFilePath();
+            if (QFile::remove(path)) {
+                removed << path;
+            }
+        }
+        return removed;
+    }
 } // namespace Tools
@@ -117,6 +117,7 @@ namespace Tools
     QVariantMap qo2qvm(const QObject* object, const QStringList& ignoredProperties = {"objectName"});
 
     QString substituteBackupFilePath(QString pattern, const QString& databasePath);
+    QStringList pruneBackupFiles(QString pattern, const QString& databasePath, int maxBackups);
 } // namespace Tools
 
 #endif // KEEPASSX_TOOLS_H
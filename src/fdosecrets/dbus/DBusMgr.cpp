@@ -228,6 +228,10 @@ namespace FdoSecrets
         m_watcher.setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
         connect(&m_watcher, &QDBusServiceWatcher::serviceUnregistered, this, &DBusMgr::dbusServiceUnregistered);
         m_watcher.setConnection(m_conn);
+
+        m_pendingTimer.setSingleShot(true);
+        m_pendingTimer.setInterval(ChangeSignalDelay);
+        connect(&m_pendingTimer, &QTimer::timeout, this, &DBusMgr::flushPendingSignals);
     }
 
     void DBusMgr::populateMethodCache()
@@ -240,7 +244,10 @@ namespace FdoSecrets
         populateMethodCache(Session::staticMetaObject);
     }
 
-    DBusMgr::~DBusMgr() = default;
+    DBusMgr::~DBusMgr()
+    {
+        flushPendingSignals();
+    }
 
     void DBusMgr::overrideClient(const DBusClientPtr& fake)
     {
@@ -355,7 +362,17 @@ namespace FdoSecrets
         switch (parsed.type) {
         case PathType::Service:
             return IntrospectionService;
-        case PathType::Collection:
+        case PathType::Collection: {
+            // items live below the collection's subpath registration, list them as child nodes
+            QString xml = IntrospectionCollection;
+            auto coll = qobject_cast<Collection*>(m_objects.value(path, nullptr));
+            if (coll) {
+                for (const auto& id : coll->itemIds()) {
+                    xml += QStringLiteral("<node name=\"%1\"/>\n").arg(id);
+                }
+            }
+            return xml;
+        }
         case PathType::Aliases:
             return IntrospectionCollection;
         case PathType::Prompt:
@@ -405,9 +422,12 @@ namespace FdoSecrets
             .arg(otherService);
     }
 
-    bool DBusMgr::registerObject(const QString& path, DBusObject* obj, bool primary)
+    bool DBusMgr::registerObject(const QString& path,
+                                 DBusObject* obj,
+                                 bool primary,
+                                 QDBusConnection::VirtualObjectRegisterOption options)
     {
-        if (!m_conn.registerVirtualObject(path, this)) {
+        if (!m_conn.registerVirtualObject(path, this, options)) {
             qDebug() << "failed to register" << obj << "at" << path;
             return false;
         }
@@ -447,21 +467,30 @@ namespace FdoSecrets
     {
         auto name = encodePath(coll->name());
         auto path = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, name);
-        if (!registerObject(path, coll)) {
+        // the subpath registration routes messages for items that are not created yet to us
+        if (!registerObject(path, coll, true, QDBusConnection::SubPath)) {
             // try again with a suffix
             name.append(QString("_%1").arg(Tools::uuidToHex(QUuid::createUuid()).left(4)));
             path = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, name);
 
-            if (!registerObject(path, coll)) {
+            if (!registerObject(path, coll, true, QDBusConnection::SubPath)) {
                 qDebug() << "Failed to register database on DBus under name" << name;
                 emit error(tr("Failed to register database on DBus under the name '%1'").arg(name));
                 return false;
             }
         }
 
-        connect(coll, &Collection::itemCreated, this, &DBusMgr::emitItemCreated);
-        connect(coll, &Collection::itemChanged, this, &DBusMgr::emitItemChanged);
-        connect(coll, &Collection::itemDeleted, this, &DBusMgr::emitItemDeleted);
+        connect(coll, &Collection::itemCreated, this, [this, coll](const QDBusObjectPath& item) {
+            emitItemSignal(coll, QStringLiteral("ItemCreated"), item);
+        });
+        connect(coll, &Collection::itemChanged, this, [this, coll](const QDBusObjectPath& item) {
+            emitItemChanged(coll, item);
+        });
+        connect(coll, &Collection::itemDeleted, this, [this, coll](const QDBusObjectPath& item) {
+            // a change that was not sent yet is moot now
+            dropPendingSignals(item, false);
+            emitItemSignal(coll, QStringLiteral("ItemDeleted"), item);
+        });
 
         return true;
     }
@@ -478,14 +507,41 @@ namespace FdoSecrets
 
     bool DBusMgr::registerObject(Item* item)
     {
-        auto path = DBUS_PATH_TEMPLATE_ITEM.arg(item->collection()->objectPath().path(), item->backend()->uuidToHex());
-        if (!registerObject(path, item)) {
+        // the path is already served by the subpath registration of the collection,
+        // so the item only has to be known here
+        auto path = item->collection()->itemPath(item->backend()).path();
+        if (m_objects.value(path)) {
             emit error(tr("Failed to register item on DBus at path '%1'").arg(path));
             return false;
         }
+        connect(item, &DBusObject::destroyed, this, &DBusMgr::unregisterObject);
+        m_objects.insert(path, item);
+        item->setObjectPath(path);
         return true;
     }
 
+    DBusObject* DBusMgr::objectAt(const QString& path)
+    {
+        auto obj = m_objects.value(path, nullptr);
+        if (obj) {
+            if (auto item = qobject_cast<Item*>(obj)) {
+                item->markUsed();
+            }
+            return obj;
+        }
+
+        auto parsed = parsePath(path);
+        if (parsed.type != PathType::Item) {
+            return nullptr;
+        }
+        auto collPath = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, parsed.parentId);
+        auto coll = qobject_cast<Collection*>(m_objects.value(collPath, nullptr));
+        if (!coll) {
+            return nullptr;
+        }
+        return coll->itemForId(parsed.id);
+    }
+
     bool DBusMgr::registerObject(PromptBase* prompt)
     {
         auto path = DBUS_PATH_TEMPLATE_PROMPT.arg(DBUS_PATH_SECRETS, Tools::uuidToHex(QUuid::createUuid()));
@@ -501,9 +557,13 @@ namespace FdoSecrets
 
     void DBusMgr::unregisterObject(DBusObject* obj)
     {
-        auto count = m_objects.remove(obj->objectPath().path());
+        const auto path = obj->objectPath().path();
+        auto count = m_objects.remove(path);
         if (count > 0) {
-            m_conn.unregisterObject(obj->objectPath().path());
+            // items were never registered on the connection by themselves
+            if (parsePath(path).type != PathType::Item) {
+                m_conn.unregisterObject(path);
+            }
             obj->setObjectPath("/");
         }
     }
@@ -539,60 +599,96 @@ namespace FdoSecrets
 
     void DBusMgr::emitCollectionChanged(Collection* coll)
     {
-        QVariantList args;
-        args += QVariant::fromValue(coll->objectPath());
-        sendDBusSignal(DBUS_PATH_SECRETS, DBUS_INTERFACE_SECRET_SERVICE, "CollectionChanged", args);
+        queueChangeSignal(
+            DBUS_PATH_SECRETS, DBUS_INTERFACE_SECRET_SERVICE, QStringLiteral("CollectionChanged"), coll->objectPath());
     }
 
     void DBusMgr::emitCollectionDeleted(Collection* coll)
     {
+        dropPendingSignals(coll->objectPath(), true);
+
         QVariantList args;
         args += QVariant::fromValue(coll->objectPath());
         sendDBusSignal(DBUS_PATH_SECRETS, DBUS_INTERFACE_SECRET_SERVICE, QStringLiteral("CollectionDeleted"), args);
     }
 
-    void DBusMgr::emitItemCreated(Item* item)
+    void DBusMgr::emitItemSignal(Collection* coll, const QString& name, const QDBusObjectPath& item)
     {
-        auto coll = item->collection();
         QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
+        args += QVariant::fromValue(item);
         // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemCreated"), args);
+        sendDBusSignal(coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, name, args);
         // also send on all alias path
         for (const auto& alias : coll->aliases()) {
             auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemCreated"), args);
+            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, name, args);
         }
     }
 
-    void DBusMgr::emitItemChanged(Item* item)
+    void DBusMgr::emitItemChanged(Collection* coll, const QDBusObjectPath& item)
     {
-        auto coll = item->collection();
-        QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
-        // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemChanged"), args);
-        // also send on all alias path
+        const auto name = QStringLiteral("ItemChanged");
+        queueChangeSignal(coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, name, item);
         for (const auto& alias : coll->aliases()) {
             auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemChanged"), args);
+            queueChangeSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, name, item);
         }
     }
 
-    void DBusMgr::emitItemDeleted(Item* item)
+    void DBusMgr::queueChangeSignal(const QString& path,
+                                    const QString& interface,
+                                    const QString& name,
+                                    const QDBusObjectPath& object)
     {
-        auto coll = item->collection();
-        QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
-        // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemDeleted"), args);
-        // also send on all alias path
-        for (const auto& alias : coll->aliases()) {
-            auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemDeleted"), args);
+        auto& pending = m_pendingSignals[object.path()];
+        if (pending.isEmpty()) {
+            m_pendingOrder.append(object.path());
+        }
+        for (const auto& sig : asConst(pending)) {
+            if (sig.path == path && sig.name == name) {
+                return;
+            }
+        }
+        pending.append({path, interface, name});
+
+        if (!m_pendingTimer.isActive()) {
+            m_pendingTimer.start();
+        }
+    }
+
+    void DBusMgr::dropPendingSignals(const QDBusObjectPath& object, bool recursive)
+    {
+        m_pendingSignals.remove(object.path());
+        if (!recursive) {
+            return;
+        }
+        const auto prefix = object.path() + QLatin1Char('/');
+        for (auto it = m_pendingSignals.begin(); it != m_pendingSignals.end();) {
+            if (it.key().startsWith(prefix)) {
+                it = m_pendingSignals.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void DBusMgr::flushPendingSignals()
+    {
+        m_pendingTimer.stop();
+
+        // sending may trigger more changes, start over with empty queues
+        const auto order = std::move(m_pendingOrder);
+        auto pending = std::move(m_pendingSignals);
+        m_pendingOrder.clear();
+        m_pendingSignals.clear();
+
+        for (const auto& object : order) {
+            const auto queued = pending.take(object);
+            for (const auto& sig : queued) {
+                QVariantList args;
+                args += QVariant::fromValue(QDBusObjectPath(object));
+                sendDBusSignal(sig.path, sig.interface, sig.name, args);
+            }
         }
     }
 
@@ -604,6 +700,9 @@ namespace FdoSecrets
             return;
         }
 
+        // let clients see the changes made by the prompt before its completion
+        flushPendingSignals();
+
         // make sure the result contains a valid value, otherwise QDBusVariant refuses to marshall it.
         if (!result.isValid()) {
             result = QString{};
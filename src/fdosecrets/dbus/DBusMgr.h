@@ -24,6 +24,7 @@
 #include <QDBusServiceWatcher>
 #include <QDBusVirtualObject>
 #include <QDebug>
+#include <QTimer>
 #include <QtDBus>
 
 class TestFdoSecrets;
@@ -164,12 +165,12 @@ namespace FdoSecrets
          * @param path
          * @return the pointer of the object, or nullptr if path is "/"
          */
-        template <typename T> T* pathToObject(const QDBusObjectPath& path) const
+        template <typename T> T* pathToObject(const QDBusObjectPath& path)
         {
             if (path.path() == QStringLiteral("/")) {
                 return nullptr;
             }
-            auto obj = qobject_cast<T*>(m_objects.value(path.path(), nullptr));
+            auto obj = qobject_cast<T*>(objectAt(path.path()));
             if (!obj) {
                 qDebug() << "object not found at path" << path.path();
                 qDebug() << m_objects;
@@ -184,7 +185,7 @@ namespace FdoSecrets
          * @param paths
          * @return
          */
-        template <typename T> QList<T*> pathsToObject(const QList<QDBusObjectPath>& paths) const
+        template <typename T> QList<T*> pathsToObject(const QList<QDBusObjectPath>& paths)
         {
             QList<T*> res;
             res.reserve(paths.size());
@@ -200,6 +201,15 @@ namespace FdoSecrets
         // Force client to be a specific object, used for testing
         void overrideClient(const DBusClientPtr& fake);
 
+        /**
+         * Send all change notifications that are still being coalesced.
+         * Called when a database operation completes, so clients see its result right away.
+         */
+        void flushPendingSignals();
+
+        // window in which change notifications for the same object are merged
+        static constexpr int ChangeSignalDelay = 100;
+
     signals:
         void clientConnected(const DBusClientPtr& client);
         void clientDisconnected(const DBusClientPtr& client);
@@ -209,9 +219,6 @@ namespace FdoSecrets
         void emitCollectionCreated(Collection* coll);
         void emitCollectionChanged(Collection* coll);
         void emitCollectionDeleted(Collection* coll);
-        void emitItemCreated(Item* item);
-        void emitItemChanged(Item* item);
-        void emitItemDeleted(Item* item);
         void emitPromptCompleted(bool dismissed, QVariant result);
 
         void dbusServiceUnregistered(const QString& service);
@@ -227,6 +234,32 @@ namespace FdoSecrets
                             const QVariantList& arguments);
         bool sendDBus(const QDBusMessage& reply);
 
+        void emitItemSignal(Collection* coll, const QString& name, const QDBusObjectPath& item);
+        void emitItemChanged(Collection* coll, const QDBusObjectPath& item);
+
+        // change notifications about the same object within ChangeSignalDelay are only sent once
+        struct PendingSignal
+        {
+            QString path;
+            QString interface;
+            QString name;
+        };
+        void queueChangeSignal(const QString& path,
+                               const QString& interface,
+                               const QString& name,
+                               const QDBusObjectPath& object);
+        /**
+         * Forget pending change notifications about an object that is going away
+         * @param object the object path
+         * @param recursive also forget the ones about objects below it
+         */
+        void dropPendingSignals(const QDBusObjectPath& object, bool recursive);
+
+        // keyed by the object path the signals are about, m_pendingOrder keeps the order of first change
+        QHash<QString, QList<PendingSignal>> m_pendingSignals{};
+        QStringList m_pendingOrder{};
+        QTimer m_pendingTimer{};
+
         // object path registration
         QHash<QString, QPointer<DBusObject>> m_objects{};
         enum class PathType
@@ -253,7 +286,17 @@ namespace FdoSecrets
             }
         };
         static ParsedPath parsePath(const QString& path);
-        bool registerObject(const QString& path, DBusObject* obj, bool primary = true);
+        bool registerObject(const QString& path,
+                            DBusObject* obj,
+                            bool primary = true,
+                            QDBusConnection::VirtualObjectRegisterOption options = QDBusConnection::SingleNode);
+
+        /**
+         * Find the object registered at path. Items are not registered up front,
+         * the owning collection creates them the first time their path is used.
+         * @return the object, or nullptr if there is none
+         */
+        DBusObject* objectAt(const QString& path);
 
         // method dispatching
         struct MethodData
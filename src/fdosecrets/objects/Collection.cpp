@@ -56,6 +56,14 @@ namespace FdoSecrets
             }
             emit doneUnlockCollection(accepted);
         });
+
+        // coalesced change notifications are sent once an operation on the database completes
+        connect(backend, &DatabaseWidget::databaseModified, this, [this]() { dbus()->flushPendingSignals(); });
+        connect(backend, &DatabaseWidget::databaseMerged, this, [this]() { dbus()->flushPendingSignals(); });
+
+        // items are created on demand, drop the ones clients stopped using
+        m_evictTimer.setInterval(ItemIdleTimeout / 5);
+        connect(&m_evictTimer, &QTimer::timeout, this, [this]() { evictIdleItems(); });
     }
 
     bool Collection::reloadBackend()
@@ -64,10 +72,7 @@ namespace FdoSecrets
 
         // delete all items
         // this has to be done because the backend is actually still there, just we don't expose them
-        // NOTE: Do NOT use a for loop, because Item::removeFromDBus will remove itself from m_items.
-        while (!m_items.isEmpty()) {
-            m_items.first()->removeFromDBus();
-        }
+        removeAllItems();
         cleanupConnections();
         dbus()->unregisterObject(this);
 
@@ -113,13 +118,24 @@ namespace FdoSecrets
         return {};
     }
 
-    DBusResult Collection::items(QList<Item*>& items) const
+    DBusResult Collection::items(QList<Item*>& items)
     {
         auto ret = ensureBackend();
         if (ret.err()) {
             return ret;
         }
-        items = m_items;
+        items.clear();
+        if (m_entries.isEmpty()) {
+            return {};
+        }
+        // keep the tree order of entries
+        items.reserve(m_entries.size());
+        for (const auto& entry : m_exposedGroup->entriesRecursive(false)) {
+            auto item = itemForEntry(entry);
+            if (item) {
+                items << item;
+            }
+        }
         return {};
     }
 
@@ -229,37 +245,59 @@ namespace FdoSecrets
         // shortcut logic for Uuid/Path attributes, as they can uniquely identify an item.
         if (attributes.contains(ItemAttributes::UuidKey)) {
             auto uuid = QUuid::fromRfc4122(QByteArray::fromHex(attributes.value(ItemAttributes::UuidKey).toLatin1()));
-            auto entry = m_exposedGroup->findEntryByUuid(uuid);
-            if (entry) {
-                items += m_entryToItem.value(entry);
+            auto item = itemForEntry(m_exposedGroup->findEntryByUuid(uuid));
+            if (item) {
+                items += item;
             }
             return {};
         }
 
         if (attributes.contains(ItemAttributes::PathKey)) {
             auto path = attributes.value(ItemAttributes::PathKey);
-            auto entry = m_exposedGroup->findEntryByPath(path);
-            if (entry) {
-                items += m_entryToItem.value(entry);
+            auto item = itemForEntry(m_exposedGroup->findEntryByPath(path));
+            if (item) {
+                items += item;
             }
             return {};
         }
 
-        QList<EntrySearcher::SearchTerm> terms;
+        if (attributes.isEmpty()) {
+            return {};
+        }
+
+        // collect a posting list for every attribute and intersect them, starting from the shortest
+        QList<QList<Entry*>> postings;
         for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
-            terms << attributeToTerm(it.key(), it.value());
-        }
-
-        constexpr auto caseSensitive = false;
-        constexpr auto skipProtected = true;
-        constexpr auto forceSearch = true;
-        const auto foundEntries =
-            EntrySearcher(caseSensitive, skipProtected).search(terms, m_exposedGroup, forceSearch);
-        items.reserve(foundEntries.size());
-        for (const auto& entry : foundEntries) {
-            const auto item = m_entryToItem.value(entry);
-            // it's possible that we don't have a corresponding item for the entry
-            // this can happen when the recycle bin is below the exposed group.
+            auto posting = m_attributeIndex.values(qMakePair(it.key(), it.value()));
+            // title, username and url are matched after resolving placeholders,
+            // which may depend on other entries, so check those at query time
+            for (auto entry : m_unresolvedIndex.values(it.key())) {
+                if (entry->resolvePlaceholder(entry->attributes()->value(it.key())) == it.value()) {
+                    posting << entry;
+                }
+            }
+            if (posting.isEmpty()) {
+                return {};
+            }
+            postings << posting;
+        }
+
+        std::sort(postings.begin(), postings.end(), [](const QList<Entry*>& lhs, const QList<Entry*>& rhs) {
+            return lhs.size() < rhs.size();
+        });
+
+        QList<QSet<Entry*>> others;
+        for (int i = 1; i < postings.size(); ++i) {
+            others << QSet<Entry*>::fromList(postings.at(i));
+        }
+        for (const auto& entry : asConst(postings.first())) {
+            if (!std::all_of(others.cbegin(), others.cend(), [entry](const QSet<Entry*>& set) {
+                    return set.contains(entry);
+                })) {
+                continue;
+            }
+            // only matches get an item, the rest of the collection stays virtual
+            auto item = itemForEntry(entry);
             if (item) {
                 items << item;
             }
@@ -267,27 +305,6 @@ namespace FdoSecrets
         return {};
     }
 
-    EntrySearcher::SearchTerm Collection::attributeToTerm(const QString& key, const QString& value)
-    {
-        static QMap<QString, EntrySearcher::Field> attrKeyToField{
-            {EntryAttributes::TitleKey, EntrySearcher::Field::Title},
-            {EntryAttributes::UserNameKey, EntrySearcher::Field::Username},
-            {EntryAttributes::URLKey, EntrySearcher::Field::Url},
-            {EntryAttributes::NotesKey, EntrySearcher::Field::Notes},
-        };
-
-        EntrySearcher::SearchTerm term{};
-        term.field = attrKeyToField.value(key, EntrySearcher::Field::AttributeValue);
-        term.word = key;
-        term.exclude = false;
-        term.regex =
-            Tools::convertToRegex(value,
-                                  Tools::RegexConvertOpts::EXACT_MATCH | Tools::RegexConvertOpts::CASE_SENSITIVE
-                                      | Tools::RegexConvertOpts::ESCAPE_REGEX);
-
-        return term;
-    }
-
     DBusResult Collection::createItem(const QVariantMap& properties,
                                       const Secret& secret,
                                       bool replace,
@@ -478,9 +495,7 @@ namespace FdoSecrets
         // delete all items
         // this has to be done because the backend is actually still there
         // just we don't expose them
-        for (const auto& item : asConst(m_items)) {
-            item->removeFromDBus();
-        }
+        removeAllItems();
 
         // repopulate
         if (!backendLocked()) {
@@ -494,27 +509,151 @@ namespace FdoSecrets
             return;
         }
 
-        auto item = Item::Create(this, entry);
-        m_items << item;
-        m_entryToItem[entry] = item;
+        // the item itself is only created once a client asks for it
+        m_entries.insert(entry);
+        indexEntry(entry);
+        connect(entry, &Entry::modified, this, &Collection::onEntryModified, Qt::UniqueConnection);
+
+        if (emitSignal) {
+            emit itemCreated(itemPath(entry));
+        }
+    }
+
+    void Collection::onEntryModified()
+    {
+        auto entry = qobject_cast<Entry*>(sender());
+        if (!entry || !m_entries.contains(entry)) {
+            return;
+        }
+
+        indexEntry(entry);
+        emit itemChanged(itemPath(entry));
+    }
+
+    void Collection::onEntryAboutToRemove(Entry* entry)
+    {
+        if (!m_entries.remove(entry)) {
+            return;
+        }
+
+        disconnect(entry, nullptr, this, nullptr);
+        unindexEntry(entry);
+        emit itemDeleted(itemPath(entry));
 
-        // forward delete signals
-        connect(entry->group(), &Group::entryAboutToRemove, item, [item](Entry* toBeRemoved) {
-            if (item->backend() == toBeRemoved) {
+        auto item = m_entryToItem.value(entry);
+        if (item) {
+            item->removeFromDBus();
+        }
+    }
+
+    void Collection::removeAllItems()
+    {
+        for (const auto& entry : asConst(m_entries)) {
+            emit itemDeleted(itemPath(entry));
+        }
+        // NOTE: Do NOT use a for loop, because Item::removeFromDBus will remove itself from m_entryToItem.
+        while (!m_entryToItem.isEmpty()) {
+            m_entryToItem.begin().value()->removeFromDBus();
+        }
+    }
+
+    Item* Collection::itemForEntry(Entry* entry)
+    {
+        if (!entry || !m_entries.contains(entry)) {
+            return nullptr;
+        }
+
+        auto item = m_entryToItem.value(entry);
+        if (!item) {
+            item = Item::Create(this, entry);
+            if (!item) {
+                return nullptr;
+            }
+            m_entryToItem.insert(entry, item);
+            connect(item, &Item::itemAboutToDelete, this, [this, entry]() { m_entryToItem.remove(entry); });
+
+            if (!m_evictTimer.isActive()) {
+                m_evictTimer.start();
+            }
+        }
+
+        item->markUsed();
+        return item;
+    }
+
+    Item* Collection::itemForId(const QString& id)
+    {
+        if (backendLocked() || !m_exposedGroup) {
+            return nullptr;
+        }
+        auto uuid = QUuid::fromRfc4122(QByteArray::fromHex(id.toLatin1()));
+        return itemForEntry(m_exposedGroup->findEntryByUuid(uuid));
+    }
+
+    QDBusObjectPath Collection::itemPath(const Entry* entry) const
+    {
+        return QDBusObjectPath(DBUS_PATH_TEMPLATE_ITEM.arg(objectPath().path(), entry->uuidToHex()));
+    }
+
+    QStringList Collection::itemIds() const
+    {
+        QStringList ids;
+        ids.reserve(m_entries.size());
+        for (const auto& entry : m_entries) {
+            ids << entry->uuidToHex();
+        }
+        return ids;
+    }
+
+    void Collection::evictIdleItems(qint64 maxIdleMs)
+    {
+        const auto items = m_entryToItem.values();
+        for (const auto& item : items) {
+            if (item->idleTime() >= maxIdleMs) {
                 item->removeFromDBus();
             }
-        });
+        }
 
-        // relay signals
-        connect(item, &Item::itemChanged, this, [this, item]() { emit itemChanged(item); });
-        connect(item, &Item::itemAboutToDelete, this, [this, item]() {
-            m_items.removeAll(item);
-            m_entryToItem.remove(item->backend());
-            emit itemDeleted(item);
-        });
+        if (m_entryToItem.isEmpty()) {
+            m_evictTimer.stop();
+        }
+    }
 
-        if (emitSignal) {
-            emit itemCreated(item);
+    void Collection::indexEntry(Entry* entry)
+    {
+        unindexEntry(entry);
+
+        static const QSet<QString> resolvedKeys{
+            EntryAttributes::TitleKey,
+            EntryAttributes::UserNameKey,
+            EntryAttributes::URLKey,
+        };
+
+        const auto attributes = entry->attributes();
+        auto& indexed = m_indexedAttributes[entry];
+        for (const auto& key : attributes->keys()) {
+            if (attributes->isProtected(key)) {
+                continue;
+            }
+            const auto value = attributes->value(key);
+            if (resolvedKeys.contains(key) && value.contains('{')) {
+                m_unresolvedIndex.insert(key, entry);
+                continue;
+            }
+            const auto attribute = qMakePair(key, value);
+            m_attributeIndex.insert(attribute, entry);
+            indexed << attribute;
+        }
+    }
+
+    void Collection::unindexEntry(Entry* entry)
+    {
+        const auto indexed = m_indexedAttributes.take(entry);
+        for (const auto& attribute : indexed) {
+            m_attributeIndex.remove(attribute, entry);
+        }
+        for (const auto& key : m_unresolvedIndex.uniqueKeys()) {
+            m_unresolvedIndex.remove(key, entry);
         }
     }
 
@@ -526,6 +665,7 @@ namespace FdoSecrets
 
         connect(group, &Group::modified, this, &Collection::collectionChanged);
         connect(group, &Group::entryAdded, this, [this](Entry* entry) { onEntryAdded(entry, true); });
+        connect(group, &Group::entryAboutToRemove, this, &Collection::onEntryAboutToRemove);
 
         const auto children = group->children();
         for (const auto& cg : children) {
@@ -602,7 +742,16 @@ namespace FdoSecrets
             }
         }
 
-        m_items.clear();
+        for (const auto& entry : asConst(m_entries)) {
+            entry->disconnect(this);
+        }
+
+        m_entries.clear();
+        m_entryToItem.clear();
+        m_evictTimer.stop();
+        m_attributeIndex.clear();
+        m_indexedAttributes.clear();
+        m_unresolvedIndex.clear();
     }
 
     QString Collection::backendFilePath() const
@@ -709,10 +858,8 @@ namespace FdoSecrets
         // the item was just created so there is no point in having it not authorized
         client->setItemAuthorized(entry->uuid(), AuthDecision::Allowed);
 
-        // when creation finishes in backend, we will already have item
-        auto created = m_entryToItem.value(entry, nullptr);
-
-        return created;
+        // the entry is exposed as soon as it is added to the group
+        return itemForEntry(entry);
     }
 
 } // namespace FdoSecrets
@@ -21,7 +21,9 @@
 #include "fdosecrets/dbus/DBusClient.h"
 #include "fdosecrets/dbus/DBusObject.h"
 
-#include "core/EntrySearcher.h"
+#include <QHash>
+#include <QPair>
+#include <QTimer>
 
 class Database;
 class DatabaseWidget;
@@ -52,7 +54,7 @@ namespace FdoSecrets
          */
         static Collection* Create(Service* parent, DatabaseWidget* backend);
 
-        Q_INVOKABLE DBUS_PROPERTY DBusResult items(QList<Item*>& items) const;
+        Q_INVOKABLE DBUS_PROPERTY DBusResult items(QList<Item*>& items);
 
         Q_INVOKABLE DBUS_PROPERTY DBusResult label(QString& label) const;
         Q_INVOKABLE DBusResult setLabel(const QString& label);
@@ -71,9 +73,10 @@ namespace FdoSecrets
         createItem(const QVariantMap& properties, const Secret& secret, bool replace, Item*& item, PromptBase*& prompt);
 
     signals:
-        void itemCreated(Item* item);
-        void itemDeleted(Item* item);
-        void itemChanged(Item* item);
+        // items are created lazily, so these carry the object path instead of the Item
+        void itemCreated(const QDBusObjectPath& item);
+        void itemDeleted(const QDBusObjectPath& item);
+        void itemChanged(const QDBusObjectPath& item);
 
         void collectionChanged();
         void collectionAboutToDelete();
@@ -95,6 +98,39 @@ namespace FdoSecrets
 
         DBusResult removeAlias(QString alias);
         DBusResult addAlias(QString alias);
+
+        /**
+         * Get the item exposing an entry, creating and registering it on DBus on first use
+         * @param entry an entry under the exposed group
+         * @return the item, or nullptr if the entry is not exposed by this collection
+         */
+        Item* itemForEntry(Entry* entry);
+
+        /**
+         * Like itemForEntry, but look up the entry by the last component of the item's object path
+         * @param id hex encoded uuid of the entry
+         */
+        Item* itemForId(const QString& id);
+
+        /**
+         * The object path of the item exposing the entry, whether or not the item exists yet
+         */
+        QDBusObjectPath itemPath(const Entry* entry) const;
+
+        /**
+         * @return the last path component of all exposed items, including those not created yet
+         */
+        QStringList itemIds() const;
+
+        static constexpr qint64 ItemIdleTimeout = 5 * 60 * 1000;
+
+        /**
+         * Unregister and delete items that have not been used for some time.
+         * They are recreated when a client addresses them again.
+         * @param maxIdleMs idle time after which an item is evicted
+         */
+        void evictIdleItems(qint64 maxIdleMs = ItemIdleTimeout);
+
         const QSet<QString> aliases() const;
 
         /**
@@ -113,8 +149,6 @@ namespace FdoSecrets
         bool inRecycleBin(Group* group) const;
         bool inRecycleBin(Entry* entry) const;
 
-        static EntrySearcher::SearchTerm attributeToTerm(const QString& key, const QString& value);
-
     public slots:
         // expose some methods for Prompt to use
 
@@ -140,6 +174,9 @@ namespace FdoSecrets
         // calls reloadBackend, delete self when error
         void reloadBackendOrDelete();
 
+        void onEntryModified();
+        void onEntryAboutToRemove(Entry* entry);
+
     private:
         friend class DeleteCollectionPrompt;
         friend class CreateCollectionPrompt;
@@ -148,6 +185,15 @@ namespace FdoSecrets
         void populateContents();
         void connectGroupSignalRecursive(Group* group);
         void cleanupConnections();
+        // emits itemDeleted for every exposed entry and deletes the existing items
+        void removeAllItems();
+
+        /**
+         * Add all unprotected attributes of the entry to the attribute index
+         * used by searchItems, replacing whatever was indexed for it before.
+         */
+        void indexEntry(Entry* entry);
+        void unindexEntry(Entry* entry);
 
         bool backendLocked() const;
 
@@ -176,8 +222,16 @@ namespace FdoSecrets
         QPointer<Group> m_exposedGroup;
 
         QSet<QString> m_aliases;
-        QList<Item*> m_items;
-        QMap<const Entry*, Item*> m_entryToItem;
+        // all exposed entries, only those used by clients have an Item
+        QSet<Entry*> m_entries;
+        QHash<const Entry*, Item*> m_entryToItem;
+        QTimer m_evictTimer;
+
+        // exact attribute key/value to entry, protected attributes are never indexed
+        QMultiHash<QPair<QString, QString>, Entry*> m_attributeIndex;
+        QHash<const Entry*, QList<QPair<QString, QString>>> m_indexedAttributes;
+        // entries whose title, username or url contain placeholders, keyed by attribute
+        QMultiHash<QString, Entry*> m_unresolvedIndex;
     };
 
 } // namespace FdoSecrets
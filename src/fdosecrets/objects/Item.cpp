@@ -73,7 +73,8 @@ namespace FdoSecrets
         : DBusObject(parent)
         , m_backend(backend)
     {
-        connect(m_backend, &Entry::modified, this, &Item::itemChanged);
+        // change notifications are sent by the collection, which also tracks entries without an item
+        m_lastUsed.start();
     }
 
     DBusResult Item::locked(const DBusClientPtr& client, bool& locked) const
@@ -382,6 +383,16 @@ namespace FdoSecrets
         deleteLater();
     }
 
+    void Item::markUsed()
+    {
+        m_lastUsed.restart();
+    }
+
+    qint64 Item::idleTime() const
+    {
+        return m_lastUsed.elapsed();
+    }
+
     Service* Item::service() const
     {
         return collection()->service();
@@ -21,6 +21,8 @@
 #include "fdosecrets/dbus/DBusClient.h"
 #include "fdosecrets/dbus/DBusObject.h"
 
+#include <QElapsedTimer>
+
 class Entry;
 
 namespace FdoSecrets
@@ -72,7 +74,6 @@ namespace FdoSecrets
         Q_INVOKABLE DBusResult setSecret(const DBusClientPtr& client, const Secret& secret);
 
     signals:
-        void itemChanged();
         void itemAboutToDelete();
 
     public:
@@ -91,6 +92,15 @@ namespace FdoSecrets
          */
         QString path() const;
 
+        /**
+         * Record a use of the item by a client, which keeps it from being evicted
+         */
+        void markUsed();
+        /**
+         * @return milliseconds since the item was last used
+         */
+        qint64 idleTime() const;
+
     public slots:
         // will actually delete the entry in KPXC
         bool doDelete();
@@ -113,6 +123,7 @@ namespace FdoSecrets
 
     private:
         QPointer<Entry> m_backend;
+        QElapsedTimer m_lastUsed;
     };
 
 } // namespace FdoSecrets
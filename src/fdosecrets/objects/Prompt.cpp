@@ -25,6 +25,7 @@
 
 #include "FdoSecretsSettings.h"
 #include "core/Entry.h"
+#include "core/Tools.h"
 #include "gui/MessageBox.h"
 
 #include <QThread>
@@ -213,7 +214,7 @@ namespace FdoSecrets
             m_collections << coll;
         }
         for (const auto& item : asConst(items)) {
-            m_items[item->collection()] << item;
+            m_items << qMakePair(QPointer<Collection>(item->collection()), item->backend()->uuid());
         }
     }
 
@@ -271,7 +272,13 @@ namespace FdoSecrets
         } else {
             m_numRejected += 1;
             // no longer need to unlock the item if its containing collection didn't unlock.
-            m_items.remove(coll);
+            for (auto it = m_items.begin(); it != m_items.end();) {
+                if (it->first == coll) {
+                    it = m_items.erase(it);
+                } else {
+                    ++it;
+                }
+            }
         }
 
         // if we got response for all collections
@@ -291,24 +298,24 @@ namespace FdoSecrets
 
         // flatten to list of entries
         QList<Entry*> entries;
-        for (const auto& itemsPerColl : asConst(m_items)) {
-            for (const auto& item : itemsPerColl) {
-                if (!item) {
+        for (const auto& itemRef : asConst(m_items)) {
+            const auto& coll = itemRef.first;
+            const auto& uuid = itemRef.second;
+            // the item is recreated if it was evicted, it is only gone for good with its entry
+            auto item = coll ? coll->itemForId(Tools::uuidToHex(uuid)) : nullptr;
+            if (!item) {
+                m_numRejected += 1;
+                continue;
+            }
+            if (client->itemKnown(uuid) || !FdoSecrets::settings()->confirmAccessItem()) {
+                if (!client->itemAuthorized(uuid)) {
                     m_numRejected += 1;
-                    continue;
                 }
-                auto entry = item->backend();
-                auto uuid = entry->uuid();
-                if (client->itemKnown(uuid) || !FdoSecrets::settings()->confirmAccessItem()) {
-                    if (!client->itemAuthorized(uuid)) {
-                        m_numRejected += 1;
-                    }
-                    // Already saw this entry
-                    continue;
-                }
-                m_entryToItems[uuid] = item.data();
-                entries << entry;
+                // Already saw this entry
+                continue;
             }
+            m_entryToCollection[uuid] = coll;
+            entries << item->backend();
         }
         if (!entries.isEmpty()) {
             QString app = tr("%1 (PID: %2)").arg(client->name()).arg(client->pid());
@@ -333,15 +340,18 @@ namespace FdoSecrets
         for (auto it = decisions.constBegin(); it != decisions.constEnd(); ++it) {
             auto entry = it.key();
             auto uuid = entry->uuid();
-            // get back the corresponding item
-            auto item = m_entryToItems.value(uuid);
-            if (!item) {
-                continue;
-            }
 
             // set auth
             client->setItemAuthorized(uuid, it.value());
 
+            // get back the corresponding item, it may have been evicted while the dialog was open
+            auto coll = m_entryToCollection.value(uuid);
+            auto item = coll ? coll->itemForId(Tools::uuidToHex(uuid)) : nullptr;
+            if (!item) {
+                m_numRejected += 1;
+                continue;
+            }
+
             if (client->itemAuthorized(uuid)) {
                 m_unlocked += item->objectPath();
             } else {
@@ -358,7 +368,8 @@ namespace FdoSecrets
 
     DeleteItemPrompt::DeleteItemPrompt(Service* parent, Item* item)
         : PromptBase(parent)
-        , m_item(item)
+        , m_coll(item->collection())
+        , m_itemUuid(item->backend()->uuid())
     {
     }
 
@@ -366,10 +377,11 @@ namespace FdoSecrets
     {
         MessageBox::OverrideParent override(findWindow(windowId));
 
-        // if m_item is gone, assume it's already deleted
+        // if the entry is gone, assume it's already deleted
         bool deleted = true;
-        if (m_item) {
-            deleted = m_item->doDelete();
+        auto item = m_coll ? m_coll->itemForId(Tools::uuidToHex(m_itemUuid)) : nullptr;
+        if (item) {
+            deleted = item->doDelete();
         }
         return PromptResult::accepted(deleted);
     }
@@ -444,6 +456,7 @@ namespace FdoSecrets
 
         // get itemPath to create item and
         // try to find an existing item using attributes
+        Item* item = nullptr;
         QString itemPath{};
         auto iterAttr = m_properties.find(DBUS_INTERFACE_SECRET_ITEM + ".Attributes");
         if (iterAttr != m_properties.end()) {
@@ -462,22 +475,23 @@ namespace FdoSecrets
                 return ret;
             }
             if (!existing.isEmpty() && m_replace) {
-                m_item = existing.front();
+                item = existing.front();
             }
         }
 
-        if (!m_item) {
+        if (!item) {
             // the item doesn't exist yet, create it
-            m_item = m_coll->doNewItem(client, itemPath);
-            if (!m_item) {
+            item = m_coll->doNewItem(client, itemPath);
+            if (!item) {
                 // may happen if entry somehow ends up in recycle bin
                 return DBusResult{DBUS_ERROR_SECRET_NO_SUCH_OBJECT};
             }
         }
+        m_itemUuid = item->backend()->uuid();
 
         // the item may be locked due to authorization
         // give the user a chance to unlock the item
-        auto prompt = PromptBase::Create<UnlockPrompt>(service(), QSet<Collection*>{}, QSet<Item*>{m_item});
+        auto prompt = PromptBase::Create<UnlockPrompt>(service(), QSet<Collection*>{}, QSet<Item*>{item});
         if (!prompt) {
             return DBusResult{QDBusError::InternalError};
         }
@@ -512,8 +526,13 @@ namespace FdoSecrets
         if (!m_sess || m_sess != m_secret.session) {
             return DBusResult(DBUS_ERROR_SECRET_NO_SESSION);
         }
+        if (!m_coll) {
+            return DBusResult{DBUS_ERROR_SECRET_NO_SUCH_OBJECT};
+        }
+        // look the item up again, it may have been evicted while the user was prompted
+        m_item = m_coll->itemForId(Tools::uuidToHex(m_itemUuid));
         if (!m_item) {
-            return {};
+            return DBusResult{DBUS_ERROR_SECRET_NO_SUCH_OBJECT};
         }
         auto ret = m_item->setProperties(m_properties);
         if (ret.err()) {
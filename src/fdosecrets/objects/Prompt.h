@@ -173,8 +173,9 @@ namespace FdoSecrets
         void unlockItems();
 
         QList<QPointer<Collection>> m_collections;
-        QHash<Collection*, QList<QPointer<Item>>> m_items;
-        QHash<QUuid, Item*> m_entryToItems;
+        // Items are kept by entry uuid, they may be evicted and recreated while the prompt is open
+        QList<QPair<QPointer<Collection>, QUuid>> m_items;
+        QHash<QUuid, QPointer<Collection>> m_entryToCollection;
 
         QList<QDBusObjectPath> m_unlocked;
         int m_numRejected = 0;
@@ -194,7 +195,9 @@ namespace FdoSecrets
 
         PromptResult promptSync(const DBusClientPtr& client, const QString& windowId) override;
 
-        QPointer<Item> m_item;
+        // The item is kept by entry uuid, it may be evicted and recreated before the prompt runs
+        QPointer<Collection> m_coll;
+        QUuid m_itemUuid;
     };
 
     class CreateItemPrompt : public PromptBase
@@ -219,6 +222,8 @@ namespace FdoSecrets
         Secret m_secret;
         bool m_replace;
 
+        // The item is kept by entry uuid while the user is prompted, it may be evicted meanwhile
+        QUuid m_itemUuid;
         QPointer<Item> m_item;
 
         QPointer<const Session> m_sess;
@@ -18,13 +18,13 @@
 
 #include "CsvParser.h"
 
-#include <QFile>
 #include <QTextCodec>
 
-#include "core/Tools.h"
-
 CsvParser::CsvParser()
-    : m_ch(0)
+    : m_codec(QTextCodec::codecForName("UTF-8"))
+    , m_pos(0)
+    , m_pendingCR(false)
+    , m_ch(0)
     , m_comment('#')
     , m_currCol(1)
     , m_currRow(1)
@@ -34,19 +34,17 @@ CsvParser::CsvParser()
     , m_isGood(true)
     , m_lastPos(-1)
     , m_maxCols(0)
+    , m_maxRows(0)
+    , m_totalRows(0)
     , m_qualifier('"')
     , m_separator(',')
     , m_statusMsg("")
 {
-    m_csv.setBuffer(&m_array);
-    m_ts.setDevice(&m_csv);
-    m_csv.open(QIODevice::ReadOnly);
-    m_ts.setCodec("UTF-8");
 }
 
 CsvParser::~CsvParser()
 {
-    m_csv.close();
+    m_file.close();
 }
 
 bool CsvParser::isFileLoaded()
@@ -57,9 +55,38 @@ bool CsvParser::isFileLoaded()
 bool CsvParser::reparse()
 {
     reset();
+    if (!openFile()) {
+        return false;
+    }
     return parseFile();
 }
 
+/**
+ * Parse the loaded file again and pass every row to the given handler.
+ *
+ * Rows are padded to the column count of the last parse and are not added to the
+ * table, which is left untouched. Use this to process files that are too large
+ * to be kept in memory as a whole.
+ */
+bool CsvParser::forEachRow(const RowHandler& handler)
+{
+    const int columns = m_maxCols;
+    const CsvTable table = m_table;
+
+    reset();
+    m_rowHandler = [&handler, columns](const CsvRow& row) {
+        CsvRow padded(row);
+        while (padded.size() < columns) {
+            padded.append(QString(""));
+        }
+        handler(padded);
+    };
+    bool result = openFile() && parseFile();
+    m_rowHandler = nullptr;
+    m_table = table;
+    return result;
+}
+
 bool CsvParser::parse(QFile* device)
 {
     clear();
@@ -67,33 +94,89 @@ bool CsvParser::parse(QFile* device)
         appendStatusMsg(QObject::tr("NULL device"), true);
         return false;
     }
-    if (!readFile(device)) {
+
+    // Closing the device also flushes text streams that are still writing to it
+    if (device->isOpen()) {
+        device->close();
+    }
+    m_file.setFileName(device->fileName());
+    if (!openFile()) {
         return false;
     }
+    m_isFileLoaded = true;
+    if (m_file.size() == 0) {
+        appendStatusMsg(QObject::tr("file empty").append("\n"));
+    }
     return parseFile();
 }
 
-bool CsvParser::readFile(QFile* device)
+bool CsvParser::openFile()
 {
-    if (device->isOpen()) {
-        device->close();
+    if (m_file.fileName().isEmpty()) {
+        // nothing loaded, parse as empty file
+        return true;
     }
-
-    device->open(QIODevice::ReadOnly);
-    if (!Tools::readAllFromDevice(device, m_array)) {
+    if (!m_file.open(QIODevice::ReadOnly)) {
         appendStatusMsg(QObject::tr("error reading from device"), true);
         m_isFileLoaded = false;
-    } else {
-        device->close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Make sure at least count characters after the current position are buffered.
+ *
+ * @return false if the end of the file was reached before
+ */
+bool CsvParser::fillBuffer(int count)
+{
+    while (m_buffer.size() - m_pos < count) {
+        if (!m_file.isOpen()) {
+            return false;
+        }
+
+        QByteArray chunk = m_file.read(ChunkSize);
+        if (chunk.isEmpty()) {
+            if (m_file.error() != QFileDevice::NoError) {
+                appendStatusMsg(QObject::tr("error reading from device"), true);
+            }
+            m_file.close();
+            return false;
+        }
+
+        if (!m_decoder) {
+            // Honor byte order marks like QTextStream does
+            m_decoder.reset(QTextCodec::codecForUtfText(chunk, m_codec)->makeDecoder());
+        }
+        QString text = m_decoder->toUnicode(chunk);
+        if (text.isEmpty()) {
+            continue;
+        }
 
-        m_array.replace("\r\n", "\n");
-        m_array.replace("\r", "\n");
-        if (m_array.isEmpty()) {
-            appendStatusMsg(QObject::tr("file empty").append("\n"));
+        // Normalize line endings, a CRLF pair may be split across two chunks
+        if (m_pendingCR && text.at(0) == '\n') {
+            text.remove(0, 1);
         }
-        m_isFileLoaded = true;
+        m_pendingCR = text.endsWith('\r');
+        text.replace("\r\n", "\n");
+        text.replace('\r', '\n');
+        m_buffer.append(text);
     }
-    return m_isFileLoaded;
+    return true;
+}
+
+/**
+ * Drop the text of already parsed records from the buffer.
+ */
+void CsvParser::discardConsumed()
+{
+    if (m_pos < ChunkSize) {
+        return;
+    }
+    m_buffer.remove(0, m_pos);
+    m_pos = 0;
+    m_lastPos = -1;
 }
 
 void CsvParser::reset()
@@ -105,8 +188,13 @@ void CsvParser::reset()
     m_isGood = true;
     m_lastPos = -1;
     m_maxCols = 0;
+    m_totalRows = 0;
     m_statusMsg = "";
-    m_ts.seek(0);
+    m_file.close();
+    m_decoder.reset();
+    m_buffer.clear();
+    m_pos = 0;
+    m_pendingCR = false;
     m_table.clear();
     // the following are users' concern :)
     // m_comment = '#';
@@ -120,7 +208,7 @@ void CsvParser::clear()
 {
     reset();
     m_isFileLoaded = false;
-    m_array.clear();
+    m_file.setFileName(QString());
 }
 
 bool CsvParser::parseFile()
@@ -141,6 +229,7 @@ bool CsvParser::parseFile()
 void CsvParser::parseRecord()
 {
     CsvRow row;
+    discardConsumed();
     if (isComment()) {
         skipLine();
         return;
@@ -157,10 +246,15 @@ void CsvParser::parseRecord()
         row.clear();
         return;
     }
-    m_table.push_back(row);
     if (m_maxCols < row.size()) {
         m_maxCols = row.size();
     }
+    m_totalRows++;
+    if (m_rowHandler) {
+        m_rowHandler(row);
+    } else if (m_maxRows <= 0 || m_table.size() < m_maxRows) {
+        m_table.push_back(row);
+    }
     m_currCol++;
 }
 
@@ -180,15 +274,24 @@ void CsvParser::parseField(CsvRow& row)
 
 void CsvParser::parseSimple(QString& s)
 {
-    QChar c;
-    getChar(c);
-    while ((isText(c)) && (!m_isEof)) {
-        s.append(c);
-        getChar(c);
-    }
-    if (!m_isEof) {
-        ungetChar();
+    // Copy the field up to the next separator or line break in one go,
+    // leaving the position at the terminating character
+    while (fillBuffer(1)) {
+        const QChar* data = m_buffer.constData();
+        const int end = m_buffer.size();
+        int i = m_pos;
+        while (i < end && isText(data[i])) {
+            ++i;
+        }
+        s.append(data + m_pos, i - m_pos);
+        m_lastPos = i;
+        m_pos = i;
+        if (i < end) {
+            m_isEof = false;
+            return;
+        }
     }
+    m_isEof = true;
 }
 
 void CsvParser::parseQuoted(QString& s)
@@ -214,11 +317,33 @@ void CsvParser::parseEscaped(QString& s)
 
 void CsvParser::parseEscapedText(QString& s)
 {
-    getChar(m_ch);
-    while ((!isQualifier(m_ch)) && !m_isEof) {
-        s.append(m_ch);
-        getChar(m_ch);
+    // Copy the text up to the next qualifier (or escape character) in one go
+    // and consume that character into m_ch
+    while (fillBuffer(1)) {
+        const int end = m_buffer.size();
+        int i = m_pos;
+        if (m_isBackslashSyntax) {
+            while (i < end && !isQualifier(m_buffer.at(i))) {
+                ++i;
+            }
+        } else {
+            i = m_buffer.indexOf(m_qualifier, m_pos);
+            if (i < 0) {
+                i = end;
+            }
+        }
+        s.append(m_buffer.constData() + m_pos, i - m_pos);
+        if (i > m_pos) {
+            m_ch = m_buffer.at(i - 1);
+        }
+        m_lastPos = i - 1;
+        m_pos = i;
+        if (i < end) {
+            getChar(m_ch);
+            return;
+        }
     }
+    m_isEof = true;
 }
 
 bool CsvParser::processEscapeMark(QString& s, QChar c)
@@ -275,8 +400,21 @@ void CsvParser::fillColumns()
 
 void CsvParser::skipLine()
 {
-    m_ts.readLine();
-    m_ts.seek(m_ts.pos() - 1);
+    // move to the line break ending the current line
+    int from = m_pos;
+    while (true) {
+        int i = m_buffer.indexOf('\n', from);
+        if (i >= 0) {
+            m_pos = i;
+            return;
+        }
+        from = m_buffer.size();
+        if (!fillBuffer(m_buffer.size() - m_pos + 1)) {
+            m_pos = m_buffer.size();
+            m_isEof = true;
+            return;
+        }
+    }
 }
 
 bool CsvParser::skipEndline()
@@ -287,19 +425,21 @@ bool CsvParser::skipEndline()
 
 void CsvParser::getChar(QChar& c)
 {
-    m_isEof = m_ts.atEnd();
+    m_isEof = !fillBuffer(1);
     if (!m_isEof) {
-        m_lastPos = m_ts.pos();
-        m_ts >> c;
+        m_lastPos = m_pos;
+        c = m_buffer.at(m_pos++);
     }
 }
 
 void CsvParser::ungetChar()
 {
-    if (!m_ts.seek(m_lastPos)) {
+    if (m_lastPos < 0) {
         qWarning("CSV Parser: unget lower bound exceeded");
         m_isGood = false;
+        return;
     }
+    m_pos = m_lastPos;
 }
 
 void CsvParser::peek(QChar& c)
@@ -323,7 +463,7 @@ bool CsvParser::isComment()
 {
     bool result = false;
     QChar c2;
-    qint64 pos = m_ts.pos();
+    int pos = m_pos;
 
     do {
         getChar(c2);
@@ -332,7 +472,7 @@ bool CsvParser::isComment()
     if (c2 == m_comment) {
         result = true;
     }
-    m_ts.seek(pos);
+    m_pos = pos;
     return result;
 }
 
@@ -389,7 +529,10 @@ void CsvParser::setComment(const QChar& c)
 
 void CsvParser::setCodec(const QString& s)
 {
-    m_ts.setCodec(QTextCodec::codecForName(s.toLocal8Bit()));
+    auto codec = QTextCodec::codecForName(s.toLocal8Bit());
+    if (codec) {
+        m_codec = codec;
+    }
 }
 
 void CsvParser::setFieldSeparator(const QChar& c)
@@ -402,9 +545,23 @@ void CsvParser::setTextQualifier(const QChar& c)
     m_qualifier = c.unicode();
 }
 
+/**
+ * Limit the number of rows kept in the table, 0 keeps all rows.
+ * Rows beyond the limit are still parsed and counted.
+ */
+void CsvParser::setMaxRows(int rows)
+{
+    m_maxRows = rows;
+}
+
+int CsvParser::getMaxRows() const
+{
+    return m_maxRows;
+}
+
 int CsvParser::getFileSize() const
 {
-    return m_csv.size();
+    return static_cast<int>(m_file.size());
 }
 
 const CsvTable CsvParser::getCsvTable() const
@@ -431,6 +588,11 @@ int CsvParser::getCsvRows() const
     return m_table.size();
 }
 
+int CsvParser::getTotalRows() const
+{
+    return m_totalRows;
+}
+
 void CsvParser::appendStatusMsg(const QString& s, bool isCritical)
 {
     m_statusMsg += QObject::tr("%1: (row, col) %2,%3").arg(s, m_currRow, m_currCol).append("\n");
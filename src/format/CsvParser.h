@@ -19,32 +19,52 @@
 #ifndef KEEPASSX_CSVPARSER_H
 #define KEEPASSX_CSVPARSER_H
 
-#include <QBuffer>
-#include <QTextStream>
+#include <QFile>
+#include <QScopedPointer>
+#include <QStringList>
 
-class QFile;
+#include <functional>
+
+class QTextCodec;
+class QTextDecoder;
 
 typedef QStringList CsvRow;
 typedef QList<CsvRow> CsvTable;
 
+/**
+ * CSV parser working on a stream of decoded text chunks.
+ *
+ * The file is read and decoded in blocks of ChunkSize bytes, so memory use does not
+ * depend on the file size. Only the first getMaxRows() rows are kept in the table,
+ * all rows can be processed one by one through forEachRow().
+ */
 class CsvParser
 {
 
 public:
+    using RowHandler = std::function<void(const CsvRow& row)>;
+
+    static const int ChunkSize = 64 * 1024;
+
     CsvParser();
     ~CsvParser();
     // read data from device and parse it
     bool parse(QFile* device);
     bool isFileLoaded();
-    // reparse the same buffer (device is not opened again)
+    // parse the same file again (e.g. with different settings)
     bool reparse();
+    // parse the same file again, passing every row to handler instead of the table
+    bool forEachRow(const RowHandler& handler);
     void setCodec(const QString& s);
     void setComment(const QChar& c);
     void setFieldSeparator(const QChar& c);
     void setTextQualifier(const QChar& c);
     void setBackslashSyntax(bool set);
+    void setMaxRows(int rows);
+    int getMaxRows() const;
     int getFileSize() const;
     int getCsvRows() const;
+    int getTotalRows() const;
     int getCsvCols() const;
     QString getStatus() const;
     const CsvTable getCsvTable() const;
@@ -53,8 +73,14 @@ protected:
     CsvTable m_table;
 
 private:
-    QByteArray m_array;
-    QBuffer m_csv;
+    QFile m_file;
+    QTextCodec* m_codec;
+    QScopedPointer<QTextDecoder> m_decoder;
+    // decoded text of the record being parsed and the chunks read ahead
+    QString m_buffer;
+    int m_pos;
+    bool m_pendingCR;
+    RowHandler m_rowHandler;
     QChar m_ch;
     QChar m_comment;
     unsigned int m_currCol;
@@ -63,13 +89,17 @@ private:
     bool m_isEof;
     bool m_isFileLoaded;
     bool m_isGood;
-    qint64 m_lastPos;
+    int m_lastPos;
     int m_maxCols;
+    int m_maxRows;
+    int m_totalRows;
     QChar m_qualifier;
     QChar m_separator;
     QString m_statusMsg;
-    QTextStream m_ts;
 
+    bool fillBuffer(int count);
+    void discardConsumed();
+    bool openFile();
     void getChar(QChar& c);
     void ungetChar();
     void peek(QChar& c);
@@ -91,7 +121,6 @@ private:
     void parseQuoted(QString& s);
     void parseEscaped(QString& s);
     void parseEscapedText(QString& s);
-    bool readFile(QFile* device);
     void reset();
     void clear();
     bool skipEndline();
@@ -28,6 +28,7 @@
 #include "format/KeePass2RandomStream.h"
 #include "streams/HmacBlockStream.h"
 #include "streams/StoreDataStream.h"
+#include "streams/StreamPipeline.h"
 #include "streams/SymmetricCipherStream.h"
 #include "streams/qtiocompressor.h"
 
@@ -79,41 +80,42 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
                       "If this reoccurs, then your database file may be corrupt.") + " " + tr("(HMAC mismatch)"));
         return false;
     }
-    HmacBlockStream hmacStream(device, hmacKey);
-    if (!hmacStream.open(QIODevice::ReadOnly)) {
-        raiseError(hmacStream.errorString());
+    // HMAC verification, decryption and decompression each run on their own worker thread
+    // and feed the inner header and XML parser below through bounded queues
+    StreamPipeline pipeline(m_pipelined);
+
+    QScopedPointer<HmacBlockStream> hmacStream(new HmacBlockStream(device, hmacKey));
+    if (!hmacStream->open(QIODevice::ReadOnly)) {
+        raiseError(hmacStream->errorString());
         return false;
     }
+    QIODevice* cipherInput = pipeline.addStage(hmacStream.take());
 
     auto mode = SymmetricCipher::cipherUuidToMode(db->cipher());
     if (mode == SymmetricCipher::InvalidMode) {
         raiseError(tr("Unknown cipher"));
         return false;
     }
-    SymmetricCipherStream cipherStream(&hmacStream);
-    if (!cipherStream.init(mode, SymmetricCipher::Decrypt, finalKey, m_encryptionIV)) {
-        raiseError(cipherStream.errorString());
+    QScopedPointer<SymmetricCipherStream> cipherStream(new SymmetricCipherStream(cipherInput));
+    if (!cipherStream->init(mode, SymmetricCipher::Decrypt, finalKey, m_encryptionIV)) {
+        raiseError(cipherStream->errorString());
         return false;
     }
-    if (!cipherStream.open(QIODevice::ReadOnly)) {
-        raiseError(cipherStream.errorString());
+    if (!cipherStream->open(QIODevice::ReadOnly)) {
+        raiseError(cipherStream->errorString());
         return false;
     }
     // clang-format on
+    QIODevice* xmlDevice = pipeline.addStage(cipherStream.take());
 
-    QIODevice* xmlDevice = nullptr;
-    QScopedPointer<QtIOCompressor> ioCompressor;
-
-    if (db->compressionAlgorithm() == Database::CompressionNone) {
-        xmlDevice = &cipherStream;
-    } else {
-        ioCompressor.reset(new QtIOCompressor(&cipherStream));
+    if (db->compressionAlgorithm() != Database::CompressionNone) {
+        QScopedPointer<QtIOCompressor> ioCompressor(new QtIOCompressor(xmlDevice));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::ReadOnly)) {
             raiseError(ioCompressor->errorString());
             return false;
         }
-        xmlDevice = ioCompressor.data();
+        xmlDevice = pipeline.addStage(ioCompressor.take());
     }
 
     while (readInnerHeaderField(xmlDevice) && !hasError()) {
@@ -435,6 +437,17 @@ QVariantMap Kdbx4Reader::readVariantMap(QIODevice* device)
     return vm;
 }
 
+/**
+ * Enable or disable the multi-threaded payload pipeline.
+ * When disabled, all stream stages run serially on the calling thread.
+ *
+ * @param pipelined true to verify, decrypt and decompress on worker threads
+ */
+void Kdbx4Reader::setPipelined(bool pipelined)
+{
+    m_pipelined = pipelined;
+}
+
 /**
  * @return mapping from attachment keys to binary data
  */
@@ -33,6 +33,7 @@ public:
                           QSharedPointer<const CompositeKey> key,
                           Database* db) override;
     QHash<QString, QByteArray> binaryPool() const;
+    void setPipelined(bool pipelined);
 
 protected:
     bool readHeaderField(StoreDataStream& headerStream, Database* db) override;
@@ -42,6 +43,7 @@ private:
     QVariantMap readVariantMap(QIODevice* device);
 
     QHash<QString, QByteArray> m_binaryPool;
+    bool m_pipelined = true;
 };
 
 #endif // KEEPASSX_KDBX4READER_H
@@ -117,6 +117,8 @@ ApplicationSettingsWidget::ApplicationSettingsWidget(QWidget* parent)
             m_generalUi->backupFilePath, SLOT(setEnabled(bool)));
     connect(m_generalUi->backupBeforeSaveCheckBox, SIGNAL(toggled(bool)),
             m_generalUi->backupFilePathPicker, SLOT(setEnabled(bool)));
+    connect(m_generalUi->backupBeforeSaveCheckBox, SIGNAL(toggled(bool)),
+            m_generalUi->backupCountSpinBox, SLOT(setEnabled(bool)));
     connect(m_generalUi->backupFilePathPicker, SIGNAL(pressed()), SLOT(selectBackupDirectory()));
     connect(m_generalUi->showExpiredEntriesOnDatabaseUnlockCheckBox, SIGNAL(toggled(bool)),
             SLOT(showExpiredEntriesOnDatabaseUnlockToggled(bool)));
@@ -194,6 +196,7 @@ void ApplicationSettingsWidget::loadSettings()
     m_generalUi->backupBeforeSaveCheckBox->setChecked(config()->get(Config::BackupBeforeSave).toBool());
 
     m_generalUi->backupFilePath->setText(config()->get(Config::BackupFilePathPattern).toString());
+    m_generalUi->backupCountSpinBox->setValue(config()->get(Config::BackupCount).toInt());
 
     m_generalUi->useAlternativeSaveCheckBox->setChecked(!config()->get(Config::UseAtomicSaves).toBool());
     m_generalUi->alternativeSaveComboBox->setCurrentIndex(config()->get(Config::UseDirectWriteSaves).toBool() ? 1 : 0);
@@ -344,6 +347,7 @@ void ApplicationSettingsWidget::saveSettings()
     config()->set(Config::BackupBeforeSave, m_generalUi->backupBeforeSaveCheckBox->isChecked());
 
     config()->set(Config::BackupFilePathPattern, m_generalUi->backupFilePath->text());
+    config()->set(Config::BackupCount, m_generalUi->backupCountSpinBox->value());
 
     config()->set(Config::UseAtomicSaves, !m_generalUi->useAlternativeSaveCheckBox->isChecked());
     config()->set(Config::UseDirectWriteSaves, m_generalUi->alternativeSaveComboBox->currentIndex() == 1);
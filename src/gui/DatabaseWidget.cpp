@@ -25,11 +25,13 @@
 #include <QHostInfo>
 #include <QInputDialog>
 #include <QKeyEvent>
+#include <QMutex>
 #include <QPlainTextEdit>
 #include <QProcess>
 #include <QSplitter>
 #include <QTextDocumentFragment>
 #include <QTextEdit>
+#include <QtConcurrent>
 #include <core/Tools.h>
 
 #include "autotype/AutoType.h"
@@ -68,6 +70,25 @@
 #include "gui/passkeys/PasskeyImporter.h"
 #endif
 
+/**
+ * State shared between the GUI thread and a search running on a worker thread
+ */
+struct DatabaseWidget::AsyncSearch
+{
+    // Held by the worker for the whole search, it keeps the previous results to refine them
+    QMutex mutex;
+    EntrySearcher searcher;
+    // Bumped for every new search, a running search stops as soon as it notices
+    QAtomicInt generation;
+
+    // Only accessed on the GUI thread
+    QSharedPointer<const EntrySearcher::Snapshot> snapshot;
+    QPointer<const Group> snapshotGroup;
+    QString labelText;
+    QList<Entry*> results;
+    bool displayed = false;
+};
+
 DatabaseWidget::DatabaseWidget(QSharedPointer<Database> db, QWidget* parent)
     : QStackedWidget(parent)
     , m_db(std::move(db))
@@ -91,7 +112,9 @@ DatabaseWidget::DatabaseWidget(QSharedPointer<Database> db, QWidget* parent)
     , m_groupView(new GroupView(m_db.data(), this))
     , m_tagView(new TagView(this))
     , m_saveAttempts(0)
+    , m_saveQueued(false)
     , m_entrySearcher(new EntrySearcher(false))
+    , m_asyncSearch(new AsyncSearch)
 {
     Q_ASSERT(m_db);
 
@@ -260,6 +283,10 @@ DatabaseWidget::~DatabaseWidget()
     // if a copy of the QSharedPointer is created in any slots activated by the Database destructor.
     // More details: https://github.com/keepassxreboot/keepassxc/issues/6393.
     m_db.clear();
+
+    // A search still running on a worker thread must not report back to a deleted widget
+    cancelAsyncSearch();
+    QMutexLocker locker(&m_asyncSearch->mutex);
 }
 
 QSharedPointer<Database> DatabaseWidget::database() const
@@ -423,6 +450,9 @@ void DatabaseWidget::replaceDatabase(QSharedPointer<Database> db)
     auto oldDb = m_db;
     m_db = std::move(db);
     connectDatabaseSignals();
+    // Searches must not keep data of the old database around
+    m_entrySearcher->clearCache();
+    resetAsyncSearch();
     m_groupView->changeDatabase(m_db);
     m_tagView->setDatabase(m_db);
 
@@ -1228,6 +1258,7 @@ void DatabaseWidget::unlockDatabase(bool accepted)
         db = m_databaseOpenWidget->database();
     }
     replaceDatabase(db);
+    m_db->prepareNextKeyTransformation();
 
     restoreGroupEntryFocus(m_groupBeforeLock, m_entryBeforeLock);
     m_groupBeforeLock = QUuid();
@@ -1438,6 +1469,9 @@ void DatabaseWidget::performUnlockDatabase(const QString& password, const QStrin
 
 void DatabaseWidget::refreshSearch()
 {
+    // Entries may have changed, the next search cannot build on previous results
+    m_entrySearcher->clearCache();
+    resetAsyncSearch();
     if (isSearchActive()) {
         auto selectedEntry = m_entryView->currentEntry();
         search(m_lastSearchText);
@@ -1458,17 +1492,45 @@ void DatabaseWidget::search(const QString& searchtext)
         searchGroup = currentGroup();
     }
 
-    auto results = m_entrySearcher->search(searchtext, searchGroup);
+    // A search that is still running on a worker thread is outdated now
+    cancelAsyncSearch();
+
+    // Large databases are searched on a worker thread to keep typing responsive
+    if (EntrySearcher::canSearchSnapshot(searchtext)) {
+        int entryCount = 0;
+        searchGroup->forEachGroupRecursive([&entryCount](const Group* group) { entryCount += group->entries().size(); });
+        if (entryCount >= AsyncSearchThreshold) {
+            auto& snapshot = m_asyncSearch->snapshot;
+            if (!snapshot || m_asyncSearch->snapshotGroup != searchGroup
+                || !EntrySearcher::snapshotCovers(*snapshot, searchtext)) {
+                snapshot = EntrySearcher::takeSnapshot(searchGroup, searchtext);
+                m_asyncSearch->snapshotGroup = searchGroup;
+            }
+            startAsyncSearch(searchtext);
+            return;
+        }
+    }
+
+    // Typing usually narrows down the previous search, so only its results need to be filtered
+    auto results = m_entrySearcher->searchIncremental(searchtext, searchGroup);
 
+    auto labelText = m_nextSearchLabelText;
+    m_nextSearchLabelText.clear();
+    showSearchResults(searchtext, results, labelText);
+}
+
+void DatabaseWidget::showSearchResults(const QString& searchtext,
+                                       const QList<Entry*>& results,
+                                       const QString& labelText)
+{
     // Display a label detailing our search results
-    if (!m_nextSearchLabelText.isEmpty()) {
+    if (!labelText.isEmpty()) {
         // Custom searches don't display if there are no results
         if (results.isEmpty()) {
             endSearch();
             return;
         }
-        m_searchingLabel->setText(m_nextSearchLabelText);
-        m_nextSearchLabelText.clear();
+        m_searchingLabel->setText(labelText);
     } else if (!results.isEmpty()) {
         m_searchingLabel->setText(tr("Search Results (%1)").arg(results.size()));
     } else {
@@ -1488,6 +1550,113 @@ void DatabaseWidget::search(const QString& searchtext)
     emit searchModeActivated();
 }
 
+/**
+ * Search the current snapshot on a worker thread.
+ *
+ * The worker only reads the snapshot and reports indices of matching entries in batches,
+ * these are resolved and streamed into the entry view on the GUI thread. The results of
+ * the previous search stay visible until the first batch arrives.
+ */
+void DatabaseWidget::startAsyncSearch(const QString& searchtext)
+{
+    auto search = m_asyncSearch;
+    auto snapshot = search->snapshot;
+    const int generation = search->generation.loadAcquire();
+    const bool caseSensitive = m_entrySearcher->isCaseSensitive();
+
+    search->labelText = m_nextSearchLabelText;
+    search->results.clear();
+    search->displayed = false;
+    m_nextSearchLabelText.clear();
+
+    QtConcurrent::run([this, search, snapshot, generation, caseSensitive, searchtext] {
+        QMutexLocker locker(&search->mutex);
+        auto isCurrent = [&] { return search->generation.loadAcquire() == generation; };
+        if (!isCurrent()) {
+            return;
+        }
+
+        // Matches are posted while the mutex is held, the widget cannot be deleted in between
+        auto post = [&](const QList<int>& matches, bool finished) {
+            QMetaObject::invokeMethod(
+                this,
+                [this, snapshot, generation, searchtext, matches, finished] {
+                    QList<Entry*> entries;
+                    entries.reserve(matches.size());
+                    for (int index : matches) {
+                        if (auto entry = snapshot->at(index).entry) {
+                            entries.append(entry);
+                        }
+                    }
+                    addAsyncSearchResults(generation, searchtext, entries, finished);
+                },
+                Qt::QueuedConnection);
+        };
+
+        search->searcher.setCaseSensitive(caseSensitive);
+        bool completed = search->searcher.searchSnapshot(searchtext, snapshot, [&](const QList<int>& matches) {
+            if (!isCurrent()) {
+                return false;
+            }
+            if (!matches.isEmpty()) {
+                post(matches, false);
+            }
+            return true;
+        });
+        if (completed && isCurrent()) {
+            post({}, true);
+        }
+    });
+}
+
+void DatabaseWidget::addAsyncSearchResults(int generation,
+                                           const QString& searchtext,
+                                           const QList<Entry*>& entries,
+                                           bool finished)
+{
+    auto search = m_asyncSearch;
+    if (search->generation.loadAcquire() != generation) {
+        return;
+    }
+
+    if (!search->displayed) {
+        if (entries.isEmpty() && !finished) {
+            return;
+        }
+        // The first batch replaces the previous results
+        search->displayed = true;
+        search->results = entries;
+        showSearchResults(searchtext, entries, search->labelText);
+    } else if (!entries.isEmpty()) {
+        search->results.append(entries);
+        m_entryView->appendSearchResults(entries);
+    }
+
+    if (finished && search->labelText.isEmpty() && !search->results.isEmpty()) {
+        m_searchingLabel->setText(tr("Search Results (%1)").arg(search->results.size()));
+    }
+}
+
+void DatabaseWidget::cancelAsyncSearch()
+{
+    m_asyncSearch->generation.ref();
+}
+
+/**
+ * Cancel a running search and drop every copy of entry data kept for searching.
+ */
+void DatabaseWidget::resetAsyncSearch()
+{
+    cancelAsyncSearch();
+    m_asyncSearch->snapshot.reset();
+    m_asyncSearch->snapshotGroup.clear();
+    m_asyncSearch->results.clear();
+
+    // A running search stops at its next batch, the worker searcher keeps the snapshot to refine it
+    QMutexLocker locker(&m_asyncSearch->mutex);
+    m_asyncSearch->searcher.clearCache();
+}
+
 void DatabaseWidget::saveSearch(const QString& searchtext)
 {
     if (!m_db->isInitialized()) {
@@ -1616,6 +1785,8 @@ QString DatabaseWidget::getCurrentSearch()
 
 void DatabaseWidget::endSearch()
 {
+    resetAsyncSearch();
+
     if (isSearchActive()) {
         // Show the normal entry view of the current group
         emit listModeAboutToActivate();
@@ -1816,6 +1987,7 @@ bool DatabaseWidget::lock()
     sshAgent()->databaseLocked(m_db);
 #endif
 
+    // Also drops the entry data copied for searching
     endSearch();
     clearAllWidgets();
     switchToOpenDatabase(m_db->filePath());
@@ -2043,7 +2215,9 @@ EntryView* DatabaseWidget::entryView()
  * ask to disable safe saves if it is unable to save after the third attempt.
  * Set `attempt` to -1 to disable this behavior.
  *
- * @return true on success
+ * If a save is already running, another save is scheduled for when it has finished.
+ *
+ * @return true on success or if the save was scheduled
  */
 bool DatabaseWidget::save()
 {
@@ -2060,6 +2234,13 @@ bool DatabaseWidget::save()
         return saveAs();
     }
 
+    // Editing continues while saving, so autosave and the user can ask for another save
+    // from the event loop of the running one. Coalesce these into a single follow-up save.
+    if (m_db->isSaving()) {
+        m_saveQueued = true;
+        return true;
+    }
+
     // Prevent recursions and infinite save loops
     m_blockAutoSave = true;
     ++m_saveAttempts;
@@ -2136,14 +2317,7 @@ bool DatabaseWidget::saveAs()
 
 bool DatabaseWidget::performSave(QString& errorMessage, const QString& fileName)
 {
-    QPointer<QWidget> focusWidget(qApp->focusWidget());
-
-    // Lock out interactions
-    m_entryView->setDisabled(true);
-    m_groupView->setDisabled(true);
-    m_tagView->setDisabled(true);
-    QApplication::processEvents();
-
+    // The database is written from a snapshot, editing can continue while saving
     Database::SaveAction saveAction = Database::Atomic;
     if (!config()->get(Config::UseAtomicSaves).toBool()) {
         if (config()->get(Config::UseDirectWriteSaves).toBool()) {
@@ -2153,16 +2327,17 @@ bool DatabaseWidget::performSave(QString& errorMessage, const QString& fileName)
         }
     }
 
+    QString backupPattern;
     QString backupFilePath;
+    QFileInfo dbFileInfo(m_db->filePath());
     if (config()->get(Config::BackupBeforeSave).toBool()) {
-        backupFilePath = config()->get(Config::BackupFilePathPattern).toString();
+        backupPattern = config()->get(Config::BackupFilePathPattern).toString();
         // Fall back to default
-        if (backupFilePath.isEmpty()) {
-            backupFilePath = config()->getDefault(Config::BackupFilePathPattern).toString();
+        if (backupPattern.isEmpty()) {
+            backupPattern = config()->getDefault(Config::BackupFilePathPattern).toString();
         }
 
-        QFileInfo dbFileInfo(m_db->filePath());
-        backupFilePath = Tools::substituteBackupFilePath(backupFilePath, dbFileInfo.canonicalFilePath());
+        backupFilePath = Tools::substituteBackupFilePath(backupPattern, dbFileInfo.canonicalFilePath());
         if (!backupFilePath.isNull()) {
             // Note that we cannot guarantee that backupFilePath is actually a valid filename. QT currently provides
             // no function for this. Moreover, we don't check if backupFilePath is a file and not a directory.
@@ -2180,13 +2355,27 @@ bool DatabaseWidget::performSave(QString& errorMessage, const QString& fileName)
         ok = m_db->saveAs(fileName, saveAction, backupFilePath, &errorMessage);
     }
 
-    // Return control
-    m_entryView->setDisabled(false);
-    m_groupView->setDisabled(false);
-    m_tagView->setDisabled(false);
+    // Run the saves requested while this one was running once it has finished
+    if (m_saveQueued) {
+        m_saveQueued = false;
+        if (ok) {
+            QTimer::singleShot(0, this, [this] {
+                if (!isLocked() && m_db->isModified()) {
+                    save();
+                }
+            });
+        }
+    }
+
+    if (ok) {
+        // Derive the key for the next save while the user keeps working
+        m_db->prepareNextKeyTransformation();
 
-    if (focusWidget) {
-        focusWidget->setFocus();
+        // Rotate timestamped backups
+        if (!backupFilePath.isNull()) {
+            Tools::pruneBackupFiles(
+                backupPattern, dbFileInfo.canonicalFilePath(), config()->get(Config::BackupCount).toInt());
+        }
     }
 
     return ok;
@@ -277,6 +277,11 @@ private:
     void openDatabaseFromEntry(const Entry* entry, bool inBackground = true);
     void performIconDownloads(const QList<Entry*>& entries, bool force = false, bool downloadInBackground = false);
     bool performSave(QString& errorMessage, const QString& fileName = {});
+    void showSearchResults(const QString& searchtext, const QList<Entry*>& results, const QString& labelText);
+    void startAsyncSearch(const QString& searchtext);
+    void addAsyncSearchResults(int generation, const QString& searchtext, const QList<Entry*>& entries, bool finished);
+    void cancelAsyncSearch();
+    void resetAsyncSearch();
 
     QSharedPointer<Database> m_db;
 
@@ -309,9 +314,15 @@ private:
     QUuid m_entryBeforeLock;
 
     int m_saveAttempts;
+    // A save was requested while another one was running
+    bool m_saveQueued;
 
     // Search state
+    struct AsyncSearch;
+    // Databases with at least this many entries are searched on a worker thread
+    static const int AsyncSearchThreshold = 5000;
     QScopedPointer<EntrySearcher> m_entrySearcher;
+    QSharedPointer<AsyncSearch> m_asyncSearch;
     QString m_lastSearchText;
     QString m_nextSearchLabelText;
     bool m_searchLimitGroup;
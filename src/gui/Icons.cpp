@@ -48,7 +48,10 @@ private:
 
 Icons* Icons::m_instance(nullptr);
 
-Icons::Icons() = default;
+Icons::Icons()
+    : m_customIconCache(CustomIconCacheSize)
+{
+}
 
 QString Icons::applicationIconName()
 {
@@ -221,10 +224,23 @@ QPixmap Icons::customIconPixmap(const Database* db, const QUuid& uuid, IconSize
     if (!db->metadata()->hasCustomIcon(uuid)) {
         return {};
     }
+
+    // Decoding is expensive, keep the result for as long as the icon data stays the same
+    const int pixelSize = databaseIcons()->iconSize(size);
+    const auto cacheKey = QStringLiteral("%1-%2").arg(db->metadata()->customIconCacheKey(uuid)).arg(pixelSize);
+    auto& cache = instance()->m_customIconCache;
+    if (auto cached = cache.object(cacheKey)) {
+        return *cached;
+    }
+
     // Generate QIcon with pre-baked resolutions
     auto icon = QImage::fromData(db->metadata()->customIcon(uuid).data);
     auto basePixmap = QPixmap::fromImage(icon.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-    return QIcon(basePixmap).pixmap(databaseIcons()->iconSize(size));
+    auto pixmap = QIcon(basePixmap).pixmap(pixelSize);
+
+    const int cost = qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+    cache.insert(cacheKey, new QPixmap(pixmap), cost);
+    return pixmap;
 }
 
 QHash<QUuid, QPixmap> Icons::customIconsPixmaps(const Database* db, IconSize size)
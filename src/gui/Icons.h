@@ -19,6 +19,7 @@
 #ifndef KEEPASSX_ICONS_H
 #define KEEPASSX_ICONS_H
 
+#include <QCache>
 #include <QIcon>
 
 #include <core/Database.h>
@@ -47,9 +48,13 @@ public:
 private:
     Icons();
 
+    static const int CustomIconCacheSize = 32 * 1024;
+
     static Icons* m_instance;
 
     QHash<QString, QIcon> m_iconCache;
+    // Decoded custom icons, the cost of an item is its size in KiB
+    QCache<QString, QPixmap> m_customIconCache;
 
     Q_DISABLE_COPY(Icons)
 };
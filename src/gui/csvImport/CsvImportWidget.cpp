@@ -19,6 +19,7 @@
 #include "CsvImportWidget.h"
 #include "ui_CsvImportWidget.h"
 
+#include <QBuffer>
 #include <QStringListModel>
 
 #include "core/Clock.h"
@@ -189,39 +190,36 @@ QString CsvImportWidget::formatStatusText() const
 void CsvImportWidget::writeDatabase()
 {
     setRootGroup();
-    for (int r = 0; r < m_parserModel->rowCount(); ++r) {
-        // use validity of second column as a GO/NOGO for all others fields
-        if (not m_parserModel->data(m_parserModel->index(r, 1)).isValid()) {
-            continue;
-        }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    m_parserModel->forEachRecord([this](const QStringList& fields) {
         auto entry = new Entry();
         entry->setUuid(QUuid::createUuid());
-        entry->setGroup(splitGroups(m_parserModel->data(m_parserModel->index(r, 0)).toString()));
-        entry->setTitle(m_parserModel->data(m_parserModel->index(r, 1)).toString());
-        entry->setUsername(m_parserModel->data(m_parserModel->index(r, 2)).toString());
-        entry->setPassword(m_parserModel->data(m_parserModel->index(r, 3)).toString());
-        entry->setUrl(m_parserModel->data(m_parserModel->index(r, 4)).toString());
-        entry->setNotes(m_parserModel->data(m_parserModel->index(r, 5)).toString());
-
-        auto otpString = m_parserModel->data(m_parserModel->index(r, 6));
-        if (otpString.isValid() && !otpString.toString().isEmpty()) {
-            auto totp = Totp::parseSettings(otpString.toString());
+        entry->setGroup(splitGroups(fields.at(0)));
+        entry->setTitle(fields.at(1));
+        entry->setUsername(fields.at(2));
+        entry->setPassword(fields.at(3));
+        entry->setUrl(fields.at(4));
+        entry->setNotes(fields.at(5));
+
+        const auto& otpString = fields.at(6);
+        if (!otpString.isEmpty()) {
+            auto totp = Totp::parseSettings(otpString);
             if (totp->key.isEmpty()) {
                 // Bare secret, use default TOTP settings
-                totp = Totp::parseSettings({}, otpString.toString());
+                totp = Totp::parseSettings({}, otpString);
             }
             entry->setTotp(totp);
         }
 
         bool ok;
-        int icon = m_parserModel->data(m_parserModel->index(r, 7)).toInt(&ok);
+        int icon = fields.at(7).toInt(&ok);
         if (ok) {
             entry->setIcon(icon);
         }
 
         TimeInfo timeInfo;
-        if (m_parserModel->data(m_parserModel->index(r, 8)).isValid()) {
-            auto datetime = m_parserModel->data(m_parserModel->index(r, 8)).toString();
+        if (!fields.at(8).isEmpty()) {
+            const auto& datetime = fields.at(8);
             if (datetime.contains(QRegularExpression("^\\d+$"))) {
                 auto t = datetime.toLongLong();
                 if (t <= INT32_MAX) {
@@ -238,8 +236,8 @@ void CsvImportWidget::writeDatabase()
                 }
             }
         }
-        if (m_parserModel->data(m_parserModel->index(r, 9)).isValid()) {
-            auto datetime = m_parserModel->data(m_parserModel->index(r, 9)).toString();
+        if (!fields.at(9).isEmpty()) {
+            const auto& datetime = fields.at(9);
             if (datetime.contains(QRegularExpression("^\\d+$"))) {
                 auto t = datetime.toLongLong();
                 if (t <= INT32_MAX) {
@@ -254,7 +252,9 @@ void CsvImportWidget::writeDatabase()
             }
         }
         entry->setTimeInfo(timeInfo);
-    }
+    });
+    QApplication::restoreOverrideCursor();
+
     QBuffer buffer;
     buffer.open(QBuffer::ReadWrite);
 
@@ -278,12 +278,8 @@ void CsvImportWidget::setRootGroup()
     bool is_empty = false;
     bool is_label = false;
 
-    for (int r = 0; r < m_parserModel->rowCount(); ++r) {
-        // use validity of second column as a GO/NOGO for all others fields
-        if (not m_parserModel->data(m_parserModel->index(r, 1)).isValid()) {
-            continue;
-        }
-        groupLabel = m_parserModel->data(m_parserModel->index(r, 0)).toString();
+    m_parserModel->forEachRecord([&](const QStringList& fields) {
+        groupLabel = fields.at(0);
         // check if group name is either "root", "" (empty) or some other label
         groupList = groupLabel.split("/", QString::SkipEmptyParts);
         if (groupList.isEmpty()) {
@@ -297,7 +293,7 @@ void CsvImportWidget::setRootGroup()
         }
 
         groupList.clear();
-    }
+    });
 
     if ((is_empty and is_root) or (is_label and not is_empty and is_root)) {
         m_db->rootGroup()->setName("CSV IMPORTED");
@@ -24,6 +24,7 @@ CsvParserModel::CsvParserModel(QObject* parent)
     : QAbstractTableModel(parent)
     , m_skipped(0)
 {
+    setMaxRows(PreviewRows);
 }
 
 CsvParserModel::~CsvParserModel() = default;
@@ -37,7 +38,7 @@ QString CsvParserModel::getFileInfo()
 {
     QString a(tr("%1, %2, %3", "file info: bytes, rows, columns")
                   .arg(tr("%n byte(s)", nullptr, getFileSize()),
-                       tr("%n row(s)", nullptr, getCsvRows()),
+                       tr("%n row(s)", nullptr, getTotalRows()),
                        tr("%n column(s)", nullptr, qMax(0, getCsvCols() - 1))));
     return a;
 }
@@ -61,6 +62,29 @@ bool CsvParserModel::parse()
     return r;
 }
 
+/**
+ * Parse the whole file again and pass every record that is not skipped to the handler.
+ *
+ * The fields of a record are arranged like the columns of the model, so this
+ * covers the rows beyond the preview without keeping them in memory.
+ */
+bool CsvParserModel::forEachRecord(const std::function<void(const QStringList& fields)>& handler)
+{
+    int row = 0;
+    return CsvParser::forEachRow([&](const CsvRow& csvRow) {
+        if (row++ < m_skipped) {
+            return;
+        }
+        QStringList fields;
+        for (int i = 0; i < m_columnHeader.size(); ++i) {
+            // column 0 of the model data is the empty "Not present" column
+            int csvColumn = m_columnMap.value(i);
+            fields << (csvColumn > 0 ? csvRow.value(csvColumn - 1) : QString(""));
+        }
+        handler(fields);
+    });
+}
+
 void CsvParserModel::addEmptyColumn()
 {
     for (int i = 0; i < m_table.size(); ++i) {
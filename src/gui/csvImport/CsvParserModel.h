@@ -29,11 +29,15 @@ class CsvParserModel : public QAbstractTableModel, public CsvParser
     Q_OBJECT
 
 public:
+    // number of rows kept for the preview
+    static const int PreviewRows = 1000;
+
     explicit CsvParserModel(QObject* parent = nullptr);
     ~CsvParserModel() override;
     void setFilename(const QString& filename);
     QString getFileInfo();
     bool parse();
+    bool forEachRecord(const std::function<void(const QStringList& fields)>& handler);
 
     void setHeaderLabels(const QStringList& labels);
     void mapColumns(int csvColumn, int dbColumn);
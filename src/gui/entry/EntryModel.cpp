@@ -100,6 +100,31 @@ void EntryModel::setEntries(const QList<Entry*>& entries)
     endResetModel();
 }
 
+/**
+ * Add entries to a list set through setEntries without resetting the model.
+ */
+void EntryModel::appendEntries(const QList<Entry*>& entries)
+{
+    if (m_group || entries.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size() + entries.size() - 1);
+
+    m_entries.append(entries);
+    m_orgEntries.append(entries);
+
+    for (const auto entry : entries) {
+        auto group = entry->group();
+        if (group && !m_allGroups.contains(group)) {
+            m_allGroups.insert(group);
+            makeConnections(group);
+        }
+    }
+
+    endInsertRows();
+}
+
 int EntryModel::rowCount(const QModelIndex& parent) const
 {
     if (parent.isValid()) {
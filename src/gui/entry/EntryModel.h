@@ -68,6 +68,7 @@ public:
 
     void setGroup(Group* group);
     void setEntries(const QList<Entry*>& entries);
+    void appendEntries(const QList<Entry*>& entries);
     void setBackgroundColorVisible(bool visible);
 
 private slots:
@@ -228,6 +228,13 @@ void EntryView::displaySearch(const QList<Entry*>& entries)
     m_inSearchMode = true;
 }
 
+void EntryView::appendSearchResults(const QList<Entry*>& entries)
+{
+    if (m_inSearchMode) {
+        m_model->appendEntries(entries);
+    }
+}
+
 void EntryView::setFirstEntryActive()
 {
     if (m_model->rowCount() > 0) {
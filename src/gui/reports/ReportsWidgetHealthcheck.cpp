@@ -102,6 +102,8 @@ Health::Health(QSharedPointer<Database> db)
     : m_db(db)
     , m_checker(db)
 {
+    QList<QSharedPointer<Item>> items;
+    QList<const Entry*> entries;
     for (auto group : db->rootGroup()->groupsRecursive(true)) {
         // Skip recycle bin
         if (group->isRecycled()) {
@@ -118,16 +120,24 @@ Health::Health(QSharedPointer<Database> db)
                 continue;
             }
 
-            // Evaluate this entry
-            const auto item = QSharedPointer<Item>(new Item(group, entry, m_checker.evaluate(entry)));
-            if (item->exclude) {
-                m_anyExcludedEntries = true;
-            }
+            items.append(QSharedPointer<Item>(new Item(group, entry, {})));
+            entries.append(entry);
+        }
+    }
 
-            // Add entry if its password isn't at least "good"
-            if (item->health->quality() < PasswordHealth::Quality::Good) {
-                m_items.append(item);
-            }
+    // Evaluate all entries at once, this runs in parallel
+    const auto healths = m_checker.evaluate(entries);
+
+    for (int i = 0; i < items.size(); ++i) {
+        const auto& item = items[i];
+        item->health = healths[i];
+        if (item->exclude) {
+            m_anyExcludedEntries = true;
+        }
+
+        // Add entry if its password isn't at least "good"
+        if (item->health->quality() < PasswordHealth::Quality::Good) {
+            m_items.append(item);
         }
     }
 
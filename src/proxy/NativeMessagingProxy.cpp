@@ -19,10 +19,9 @@
 #include "browser/BrowserShared.h"
 
 #include <QCoreApplication>
-#include <QFuture>
-#include <QtConcurrent/qtconcurrentrun.h>
+#include <QThread>
 
-#include <iostream>
+#include <cstdio>
 
 #ifdef Q_OS_WIN
 #include <fcntl.h>
@@ -57,34 +56,53 @@ void NativeMessagingProxy::setupStandardInput()
 #endif
 #endif
 
-    QtConcurrent::run([this] {
-        while (std::cin.good()) {
-            if (std::cin.peek() != EOF) {
-                uint length = 0;
-                for (uint i = 0; i < sizeof(uint); ++i) {
-                    length |= getchar() << (i * 8);
-                }
+    // Blocking reads on a dedicated thread, messages are handed over as soon as they are complete.
+    // The thread is never joined, it is blocked in a read until stdin is closed.
+    auto reader = QThread::create([this] { readStandardInput(); });
+    connect(reader, &QThread::finished, reader, &QObject::deleteLater);
+    reader->start();
+}
 
-                QString msg;
-                msg.reserve(length);
-                for (uint i = 0; i < length; ++i) {
-                    msg.append(getchar());
-                }
+void NativeMessagingProxy::readStandardInput()
+{
+    while (true) {
+        // Every message is prefixed with its length in native byte order
+        quint32 length = 0;
+        if (std::fread(&length, sizeof(length), 1, stdin) != 1) {
+            break;
+        }
 
-                if (msg.length() > 0) {
-                    emit stdinMessage(msg);
+        if (length > static_cast<quint32>(BrowserShared::NATIVEMSG_MAX_LENGTH)) {
+            // Larger messages are not accepted by the application, skip them
+            char discard[4096];
+            while (length > 0) {
+                const auto read = std::fread(discard, 1, qMin<quint32>(length, sizeof(discard)), stdin);
+                if (read == 0) {
+                    break;
                 }
+                length -= static_cast<quint32>(read);
             }
-            QThread::msleep(100);
+            continue;
+        }
+
+        QByteArray msg(static_cast<int>(length), Qt::Uninitialized);
+        if (std::fread(msg.data(), 1, length, stdin) != length) {
+            break;
         }
-        QCoreApplication::quit();
-    });
+
+        if (!msg.isEmpty()) {
+            emit stdinMessage(msg);
+        }
+    }
+
+    QMetaObject::invokeMethod(QCoreApplication::instance(), &QCoreApplication::quit, Qt::QueuedConnection);
 }
 
-void NativeMessagingProxy::transferStdinMessage(const QString& msg)
+void NativeMessagingProxy::transferStdinMessage(const QByteArray& msg)
 {
+    // Flushed one message at a time, the application does not frame messages on the socket
     if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->write(msg.toUtf8(), msg.length());
+        m_localSocket->write(msg);
         m_localSocket->flush();
     }
 }
@@ -106,15 +124,21 @@ void NativeMessagingProxy::setupLocalSocket()
 
 void NativeMessagingProxy::transferSocketMessage()
 {
-    auto msg = m_localSocket->readAll();
-    if (!msg.isEmpty()) {
-        // Explicitly write the message length as 1 byte chunks
-        uint len = msg.size();
-        std::cout.write(reinterpret_cast<char*>(&len), sizeof(len));
-
-        // Write the message and flush the stream
-        std::cout << msg.toStdString() << std::flush;
+    // Replies sent back-to-back can arrive in a single read, each one needs its own length
+    const auto messages = BrowserShared::splitMessages(m_localSocket->readAll());
+    if (messages.isEmpty()) {
+        return;
     }
+
+    QByteArray out;
+    for (const auto& msg : messages) {
+        const auto len = static_cast<quint32>(msg.size());
+        out.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        out.append(msg);
+    }
+
+    std::fwrite(out.constData(), 1, static_cast<size_t>(out.size()), stdout);
+    std::fflush(stdout);
 }
 
 void NativeMessagingProxy::socketDisconnected()
@@ -31,16 +31,17 @@ public:
     ~NativeMessagingProxy() override = default;
 
 signals:
-    void stdinMessage(QString msg);
+    void stdinMessage(const QByteArray& msg);
 
 public slots:
     void transferSocketMessage();
-    void transferStdinMessage(const QString& msg);
+    void transferStdinMessage(const QByteArray& msg);
     void socketDisconnected();
 
 private:
     void setupStandardInput();
     void setupLocalSocket();
+    void readStandardInput();
 
 private:
     QScopedPointer<QLocalSocket> m_localSocket;
@@ -19,14 +19,17 @@
 #include "SSHAgent.h"
 
 #include "core/Config.h"
+#include "core/Global.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "sshagent/BinaryStream.h"
 #include "sshagent/KeeAgentSettings.h"
 
+#include <QCoreApplication>
 #include <QFileInfo>
 #include <QLocalSocket>
 #include <QThread>
+#include <QtConcurrent>
 
 #ifdef Q_OS_WIN
 #include <QtEndian>
@@ -35,6 +38,27 @@
 
 Q_GLOBAL_STATIC(SSHAgent, s_sshAgent);
 
+namespace
+{
+    /**
+     * Key of an entry to be added to the agent when its database is unlocked.
+     */
+    struct PendingKey
+    {
+        KeeAgentSettings settings;
+        QString username;
+        QString password;
+        const EntryAttachments* attachments = nullptr;
+        OpenSSHKey key;
+        bool opened = false;
+    };
+} // namespace
+
+SSHAgent::~SSHAgent()
+{
+    closeAgentSocket();
+}
+
 SSHAgent* SSHAgent::instance()
 {
     return s_sshAgent;
@@ -172,29 +196,125 @@ bool SSHAgent::sendMessage(const QByteArray& in, QByteArray& out)
 #endif
 }
 
-bool SSHAgent::sendMessageOpenSSH(const QByteArray& in, QByteArray& out)
+/**
+ * Send a batch of messages to the agent and collect the responses.
+ *
+ * Messages to the OpenSSH agent are pipelined over a single connection: all requests
+ * are written before the first response is read. The agent answers them in order.
+ *
+ * @param in messages to send
+ * @param out responses received so far, in the order of `in`
+ * @return true if every message got a response
+ */
+bool SSHAgent::sendMessages(const QList<QByteArray>& in, QList<QByteArray>& out)
+{
+#ifdef Q_OS_WIN
+    if (usePageant()) {
+        // Pageant only takes one message at a time
+        out.clear();
+        for (const auto& message : in) {
+            QByteArray response;
+            if (!sendMessage(message, response)) {
+                return false;
+            }
+            out.append(response);
+        }
+        return true;
+    }
+#endif
+    return sendMessagesOpenSSH(in, out);
+}
+
+bool SSHAgent::sendMessagesOpenSSH(const QList<QByteArray>& in, QList<QByteArray>& out)
 {
-    QLocalSocket socket;
-    BinaryStream stream(&socket);
+    out.clear();
+
+    // A reused connection may have been closed by the agent in the meantime, retry once on a fresh one
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = false;
+        QLocalSocket* socket = agentSocket(reused);
+        if (!socket) {
+            m_error = tr("Agent connection failed.");
+            return false;
+        }
 
-    socket.connectToServer(socketPath());
-    if (!socket.waitForConnected(500)) {
-        m_error = tr("Agent connection failed.");
-        return false;
+        BinaryStream stream(socket);
+        for (const auto& message : in) {
+            stream.writeString(message);
+        }
+        stream.flush();
+
+        while (out.size() < in.size()) {
+            QByteArray response;
+            if (!stream.readString(response)) {
+                break;
+            }
+            out.append(response);
+        }
+
+        if (out.size() == in.size()) {
+            return true;
+        }
+
+        closeAgentSocket();
+        if (!reused || !out.isEmpty()) {
+            break;
+        }
     }
 
-    stream.writeString(in);
-    stream.flush();
+    m_error = tr("Agent protocol error.");
+    return false;
+}
 
-    if (!stream.readString(out)) {
-        m_error = tr("Agent protocol error.");
+bool SSHAgent::sendMessageOpenSSH(const QByteArray& in, QByteArray& out)
+{
+    QList<QByteArray> responses;
+    if (!sendMessagesOpenSSH({in}, responses)) {
         return false;
     }
 
-    socket.close();
+    out = responses.first();
     return true;
 }
 
+/**
+ * Get the persistent connection to the OpenSSH agent, connecting if needed.
+ *
+ * @param reused set to true if the connection was already open
+ * @return connected socket or nullptr on failure
+ */
+QLocalSocket* SSHAgent::agentSocket(bool& reused)
+{
+    QString path = socketPath();
+
+    if (m_agentSocket && m_agentSocket->state() == QLocalSocket::ConnectedState
+        && m_agentSocket->serverName() == path) {
+        reused = true;
+        return m_agentSocket;
+    }
+
+    closeAgentSocket();
+    reused = false;
+
+    // Parented to the application so the socket does not outlive the event dispatcher
+    m_agentSocket = new QLocalSocket(QCoreApplication::instance());
+    m_agentSocket->connectToServer(path);
+    if (!m_agentSocket->waitForConnected(500)) {
+        closeAgentSocket();
+        return nullptr;
+    }
+
+    return m_agentSocket;
+}
+
+void SSHAgent::closeAgentSocket()
+{
+    if (m_agentSocket) {
+        m_agentSocket->abort();
+        delete m_agentSocket;
+    }
+}
+
 #ifdef Q_OS_WIN
 bool SSHAgent::sendMessagePageant(const QByteArray& in, QByteArray& out)
 {
@@ -275,12 +395,38 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
         return false;
     }
 
+    QByteArray requestData;
+    if (!prepareAddIdentity(key, settings, databaseUuid, requestData)) {
+        return false;
+    }
+
+    QByteArray responseData;
+    if (!sendMessage(requestData, responseData)) {
+        return false;
+    }
+
+    return finishAddIdentity(key, settings, databaseUuid, responseData);
+}
+
+/**
+ * Build the agent request adding an identity.
+ *
+ * @param key identity / key to add
+ * @param settings constraints (lifetime, confirm)
+ * @param databaseUuid database that owns the key
+ * @param requestData output request message
+ * @return false if the key is owned by another database
+ */
+bool SSHAgent::prepareAddIdentity(OpenSSHKey& key,
+                                  const KeeAgentSettings& settings,
+                                  const QUuid& databaseUuid,
+                                  QByteArray& requestData)
+{
     if (m_addedKeys.contains(key) && m_addedKeys[key].first != databaseUuid) {
         m_error = tr("Key identity ownership conflict. Refusing to add.");
         return false;
     }
 
-    QByteArray requestData;
     BinaryStream request(&requestData);
     bool isSecurityKey = key.type().startsWith("sk-");
 
@@ -305,11 +451,23 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
         request.writeString(securityKeyProvider());
     }
 
-    QByteArray responseData;
-    if (!sendMessage(requestData, responseData)) {
-        return false;
-    }
+    return true;
+}
 
+/**
+ * Evaluate the agent response to an add identity request and remember the added key.
+ *
+ * @param key identity that was sent
+ * @param settings constraints (lifetime, confirm), remove-on-lock
+ * @param databaseUuid database that owns the key for remove-on-lock
+ * @param responseData agent response
+ * @return true if the agent accepted the identity
+ */
+bool SSHAgent::finishAddIdentity(const OpenSSHKey& key,
+                                 const KeeAgentSettings& settings,
+                                 const QUuid& databaseUuid,
+                                 const QByteArray& responseData)
+{
     if (responseData.length() < 1 || static_cast<quint8>(responseData[0]) != SSH_AGENT_SUCCESS) {
         m_error =
             tr("Agent refused this identity. Possible reasons include:") + "\n" + tr("The key has already been added.");
@@ -322,7 +480,7 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
             m_error += "\n" + tr("A confirmation request is not supported by the agent (check options).");
         }
 
-        if (isSecurityKey) {
+        if (key.type().startsWith("sk-")) {
             m_error +=
                 "\n" + tr("Security keys are not supported by the agent or the security key provider is unavailable.");
         }
@@ -514,31 +672,85 @@ void SSHAgent::databaseUnlocked(QSharedPointer<Database> db)
         return;
     }
 
+    QList<QSharedPointer<PendingKey>> pendingKeys;
+
     for (Entry* e : db->rootGroup()->entriesRecursive()) {
         if (db->metadata()->recycleBinEnabled() && e->group() == db->metadata()->recycleBin()) {
             continue;
         }
 
-        KeeAgentSettings settings;
+        auto pending = QSharedPointer<PendingKey>::create();
 
-        if (!settings.fromEntry(e)) {
+        if (!pending->settings.fromEntry(e)) {
             continue;
         }
 
-        if (!settings.allowUseOfSshKey() || !settings.addAtDatabaseOpen()) {
+        if (!pending->settings.allowUseOfSshKey() || !pending->settings.addAtDatabaseOpen()) {
             continue;
         }
 
-        OpenSSHKey key;
+        pending->username = e->username();
+        pending->password = e->password();
+        pending->attachments = e->attachments();
+        pendingKeys.append(pending);
+    }
+
+    if (pendingKeys.isEmpty()) {
+        return;
+    }
 
-        if (!settings.toOpenSSHKey(e, key, true)) {
+    // Decrypting keys runs a deliberately slow KDF, spread it over the global thread pool.
+    // The GUI thread is blocked meanwhile, so the entry attachments stay untouched.
+    QString databasePath = db->filePath();
+    QtConcurrent::blockingMap(pendingKeys, [databasePath](const QSharedPointer<PendingKey>& pending) {
+        pending->opened = pending->settings.toOpenSSHKey(
+            pending->username, pending->password, databasePath, pending->attachments, pending->key, true);
+    });
+
+    QList<QSharedPointer<PendingKey>> keysToAdd;
+    QList<QByteArray> requests;
+
+    for (const auto& pending : asConst(pendingKeys)) {
+        if (!pending->opened) {
+            continue;
+        }
+
+        QByteArray requestData;
+        if (!prepareAddIdentity(pending->key, pending->settings, db->uuid(), requestData)) {
+            // Ignore errors if we have previously added the key
+            if (!m_addedKeys.contains(pending->key)) {
+                emit error(m_error);
+            }
             continue;
         }
 
+        keysToAdd.append(pending);
+        requests.append(requestData);
+    }
+
+    if (keysToAdd.isEmpty()) {
+        return;
+    }
+
+    if (!isAgentRunning()) {
+        emit error(tr("No agent running, cannot add identity."));
+        return;
+    }
+
+    QList<QByteArray> responses;
+    bool sent = sendMessages(requests, responses);
+
+    for (int i = 0; i < responses.size(); ++i) {
+        const auto& pending = keysToAdd[i];
+
         // Add key to agent; ignore errors if we have previously added the key
-        bool known_key = m_addedKeys.contains(key);
-        if (!addIdentity(key, settings, db->uuid()) && !known_key) {
+        bool known_key = m_addedKeys.contains(pending->key);
+        if (!finishAddIdentity(pending->key, pending->settings, db->uuid(), responses[i]) && !known_key) {
             emit error(m_error);
         }
     }
+
+    if (!sent) {
+        emit error(m_error);
+    }
 }
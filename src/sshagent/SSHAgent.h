@@ -20,18 +20,20 @@
 #define KEEPASSXC_SSHAGENT_H
 
 #include <QHash>
+#include <QPointer>
 
 #include "OpenSSHKey.h"
 
 class KeeAgentSettings;
 class Database;
+class QLocalSocket;
 
 class SSHAgent : public QObject
 {
     Q_OBJECT
 
 public:
-    ~SSHAgent() override = default;
+    ~SSHAgent() override;
     static SSHAgent* instance();
 
     bool isEnabled() const;
@@ -79,8 +81,21 @@ private:
     const quint8 SSH_AGENT_CONSTRAIN_CONFIRM = 2;
     const quint8 SSH_AGENT_CONSTRAIN_EXTENSION = 255;
 
+    bool prepareAddIdentity(OpenSSHKey& key,
+                            const KeeAgentSettings& settings,
+                            const QUuid& databaseUuid,
+                            QByteArray& requestData);
+    bool finishAddIdentity(const OpenSSHKey& key,
+                           const KeeAgentSettings& settings,
+                           const QUuid& databaseUuid,
+                           const QByteArray& responseData);
+
     bool sendMessage(const QByteArray& in, QByteArray& out);
+    bool sendMessages(const QList<QByteArray>& in, QList<QByteArray>& out);
+    bool sendMessagesOpenSSH(const QList<QByteArray>& in, QList<QByteArray>& out);
     bool sendMessageOpenSSH(const QByteArray& in, QByteArray& out);
+    QLocalSocket* agentSocket(bool& reused);
+    void closeAgentSocket();
 #ifdef Q_OS_WIN
     bool sendMessagePageant(const QByteArray& in, QByteArray& out);
 
@@ -89,6 +104,7 @@ private:
 #endif
 
     QHash<OpenSSHKey, QPair<QUuid, bool>> m_addedKeys;
+    QPointer<QLocalSocket> m_agentSocket;
     QString m_error;
 };
 
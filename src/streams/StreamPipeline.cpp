@@ -0,0 +1,240 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StreamPipeline.h"
+
+#include <QThread>
+
+#include "core/Global.h"
+
+BlockQueue::BlockQueue(int capacity)
+    : m_capacity(qMax(1, capacity))
+{
+}
+
+/**
+ * Append a block, waiting while the queue is full.
+ *
+ * @return false if the consumer aborted the queue
+ */
+bool BlockQueue::push(const QByteArray& block)
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_aborted && m_blocks.size() >= m_capacity) {
+        m_notFull.wait(&m_mutex);
+    }
+    if (m_aborted) {
+        return false;
+    }
+    m_blocks.enqueue(block);
+    m_notEmpty.wakeOne();
+    return true;
+}
+
+/**
+ * Take the next block, waiting while the queue is empty.
+ *
+ * @return false once the producer finished and all blocks were consumed, or on abort
+ */
+bool BlockQueue::pop(QByteArray& block)
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_aborted && !m_finished && m_blocks.isEmpty()) {
+        m_notEmpty.wait(&m_mutex);
+    }
+    if (m_aborted || m_blocks.isEmpty()) {
+        return false;
+    }
+    block = m_blocks.dequeue();
+    m_notFull.wakeOne();
+    return true;
+}
+
+/**
+ * Mark the end of the stream. A non-empty error string is reported to the consumer
+ * after all blocks queued so far have been read.
+ */
+void BlockQueue::finish(const QString& errorString)
+{
+    QMutexLocker locker(&m_mutex);
+    m_finished = true;
+    m_errorString = errorString;
+    m_notEmpty.wakeAll();
+}
+
+/**
+ * Drop all queued blocks and wake up both sides.
+ */
+void BlockQueue::abort()
+{
+    QMutexLocker locker(&m_mutex);
+    m_aborted = true;
+    m_blocks.clear();
+    m_notEmpty.wakeAll();
+    m_notFull.wakeAll();
+}
+
+bool BlockQueue::hasError() const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_errorString.isEmpty();
+}
+
+QString BlockQueue::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_errorString;
+}
+
+BlockQueueDevice::BlockQueueDevice(QSharedPointer<BlockQueue> queue, QObject* parent)
+    : QIODevice(parent)
+    , m_queue(std::move(queue))
+{
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+BlockQueueDevice::~BlockQueueDevice()
+{
+    close();
+}
+
+bool BlockQueueDevice::isSequential() const
+{
+    return true;
+}
+
+bool BlockQueueDevice::atEnd() const
+{
+    return m_eof && m_bufferPos == m_buffer.size();
+}
+
+qint64 BlockQueueDevice::readData(char* data, qint64 maxSize)
+{
+    qint64 bytesRemaining = maxSize;
+    qint64 offset = 0;
+
+    while (bytesRemaining > 0) {
+        if (m_bufferPos == m_buffer.size()) {
+            m_buffer.clear();
+            m_bufferPos = 0;
+            if (m_eof || !m_queue->pop(m_buffer)) {
+                m_eof = true;
+                if (m_queue->hasError()) {
+                    setErrorString(m_queue->errorString());
+                    return offset > 0 ? offset : -1;
+                }
+                return offset;
+            }
+        }
+
+        qint64 bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_buffer.size() - m_bufferPos));
+
+        memcpy(data + offset, m_buffer.constData() + m_bufferPos, static_cast<size_t>(bytesToCopy));
+
+        offset += bytesToCopy;
+        m_bufferPos += bytesToCopy;
+        bytesRemaining -= bytesToCopy;
+    }
+
+    return maxSize;
+}
+
+qint64 BlockQueueDevice::writeData(const char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+StreamPipeline::StreamPipeline(bool threaded, int queueDepth)
+    : m_threaded(threaded)
+    , m_queueDepth(queueDepth)
+{
+}
+
+StreamPipeline::~StreamPipeline()
+{
+    for (auto& queue : m_queues) {
+        queue->abort();
+    }
+    for (auto thread : asConst(m_threads)) {
+        thread->wait();
+        delete thread;
+    }
+    // Stages reference the devices created before them, tear down in reverse order
+    while (!m_ownedDevices.isEmpty()) {
+        delete m_ownedDevices.takeLast();
+    }
+}
+
+/**
+ * Append an opened stage to the pipeline.
+ *
+ * When threaded, the stage is read to its end on a new worker thread from now on and
+ * must no longer be used by the caller. The returned device yields the stage output
+ * and is what the next stage has to be layered on.
+ *
+ * @param stage opened readable device
+ * @param takeOwnership delete the stage together with the pipeline
+ * @return device providing the output of the stage
+ */
+QIODevice* StreamPipeline::addStage(QIODevice* stage, bool takeOwnership)
+{
+    Q_ASSERT(stage && stage->isReadable());
+
+    if (takeOwnership) {
+        m_ownedDevices.append(stage);
+    }
+
+    if (!m_threaded) {
+        return stage;
+    }
+
+    auto queue = QSharedPointer<BlockQueue>::create(m_queueDepth);
+    m_queues.append(queue);
+
+    auto thread = QThread::create([stage, queue] { pump(stage, queue.data()); });
+    m_threads.append(thread);
+    thread->start();
+
+    auto output = new BlockQueueDevice(queue);
+    m_ownedDevices.append(output);
+    return output;
+}
+
+/**
+ * Read the given stage to its end and forward everything to the output queue.
+ */
+void StreamPipeline::pump(QIODevice* stage, BlockQueue* output)
+{
+    while (true) {
+        QByteArray chunk(ChunkSize, Qt::Uninitialized);
+        qint64 bytesRead = stage->read(chunk.data(), ChunkSize);
+        if (bytesRead < 0) {
+            output->finish(stage->errorString().isEmpty() ? QStringLiteral("Read error.") : stage->errorString());
+            return;
+        }
+        if (bytesRead == 0) {
+            output->finish();
+            return;
+        }
+        chunk.resize(static_cast<int>(bytesRead));
+        if (!output->push(chunk)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_STREAMPIPELINE_H
+#define KEEPASSX_STREAMPIPELINE_H
+
+#include <QIODevice>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+class QThread;
+
+/**
+ * Thread-safe bounded FIFO of data chunks connecting two pipeline stages.
+ */
+class BlockQueue
+{
+public:
+    explicit BlockQueue(int capacity);
+
+    bool push(const QByteArray& block);
+    bool pop(QByteArray& block);
+    void finish(const QString& errorString = {});
+    void abort();
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    mutable QMutex m_mutex;
+    QWaitCondition m_notEmpty;
+    QWaitCondition m_notFull;
+    QQueue<QByteArray> m_blocks;
+    const int m_capacity;
+    bool m_finished = false;
+    bool m_aborted = false;
+    QString m_errorString;
+};
+
+/**
+ * Read-only sequential device draining a BlockQueue.
+ * Reads block until the requested amount of data is available or the producer finished.
+ */
+class BlockQueueDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit BlockQueueDevice(QSharedPointer<BlockQueue> queue, QObject* parent = nullptr);
+    ~BlockQueueDevice() override;
+
+    bool isSequential() const override;
+    bool atEnd() const override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    QSharedPointer<BlockQueue> m_queue;
+    QByteArray m_buffer;
+    int m_bufferPos = 0;
+    bool m_eof = false;
+};
+
+/**
+ * Chain of stream stages where every stage runs on its own worker thread.
+ *
+ * Each stage device is read to its end on a dedicated thread and its output is handed
+ * to the next stage through a bounded BlockQueue. Stage devices are constructed on the
+ * calling thread and only touched by their worker once the stage has been added, so the
+ * existing single-threaded stream classes can be reused unchanged.
+ *
+ * A pipeline that is not threaded simply chains the stages on the calling thread.
+ */
+class StreamPipeline
+{
+public:
+    static const int DefaultQueueDepth = 4;
+    static const int ChunkSize = 1024 * 1024;
+
+    explicit StreamPipeline(bool threaded = true, int queueDepth = DefaultQueueDepth);
+    ~StreamPipeline();
+
+    QIODevice* addStage(QIODevice* stage, bool takeOwnership = true);
+
+private:
+    static void pump(QIODevice* stage, BlockQueue* output);
+
+    const bool m_threaded;
+    const int m_queueDepth;
+    QList<QSharedPointer<BlockQueue>> m_queues;
+    QList<QThread*> m_threads;
+    QList<QIODevice*> m_ownedDevices;
+
+    Q_DISABLE_COPY(StreamPipeline)
+};
+
+#endif // KEEPASSX_STREAMPIPELINE_H
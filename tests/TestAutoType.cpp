@@ -279,6 +279,48 @@ void TestAutoType::testGlobalAutoTypeRegExp()
     m_test->clearActions();
 }
 
+void TestAutoType::testAutoTypeCandidates()
+{
+    // Regular expressions are checked for every window, other entries only when their text appears
+    QList<Entry*> expected{m_entry1, m_entry3, m_entry4};
+    QCOMPARE(m_db->findAutoTypeCandidates("Custom Window"), expected);
+    expected = {m_entry3, m_entry4, m_entry5};
+    QCOMPARE(m_db->findAutoTypeCandidates("example.org - Browser"), expected);
+    QCOMPARE(m_db->findAutoTypeCandidates("Some Title"), expected);
+    expected = {m_entry3, m_entry4};
+    QCOMPARE(m_db->findAutoTypeCandidates("unrelated"), expected);
+
+    // Wildcard associations are indexed by their longest literal part
+    AutoTypeAssociations::Association association;
+    association.window = "* - Mozilla Firefox";
+    m_entry2->autoTypeAssociations()->add(association);
+    expected = {m_entry2, m_entry3, m_entry4};
+    QCOMPARE(m_db->findAutoTypeCandidates("Start Page - Mozilla Firefox"), expected);
+
+    // The index follows changes to entries
+    m_entry1->autoTypeAssociations()->clear();
+    m_entry5->setTitle("custom");
+    expected = {m_entry3, m_entry4, m_entry5};
+    QCOMPARE(m_db->findAutoTypeCandidates("Custom Window"), expected);
+
+    delete m_entry5;
+    expected = {m_entry3, m_entry4};
+    QCOMPARE(m_db->findAutoTypeCandidates("Custom Window"), expected);
+
+    // Also while modified signals are disabled, as during a merge
+    m_db->setEmitModified(false);
+    association.window = "Merged Window";
+    m_entry2->autoTypeAssociations()->update(0, association);
+    m_db->setEmitModified(true);
+    expected = {m_entry2, m_entry3, m_entry4};
+    QCOMPARE(m_db->findAutoTypeCandidates("Merged Window"), expected);
+
+    // Placeholders are resolved on every lookup
+    m_entry2->setTitle("{USERNAME}");
+    expected = {m_entry2, m_entry3, m_entry4};
+    QCOMPARE(m_db->findAutoTypeCandidates("unrelated"), expected);
+}
+
 void TestAutoType::testAutoTypeResults()
 {
     QScopedPointer<Entry> entry(new Entry());
@@ -93,6 +93,33 @@ void TestBrowser::testDecryptMessage()
     QCOMPARE(decrypted["action"].toString(), QString("test-action"));
 }
 
+void TestBrowser::testSharedKey()
+{
+    QJsonObject message;
+    message["action"] = "test-action";
+
+    const auto sharedKey = browserMessageBuilder()->getSharedKey(PUBLICKEY, SERVERSECRETKEY);
+    QCOMPARE(sharedKey.size(), static_cast<size_t>(crypto_box_BEFORENMBYTES));
+    QVERIFY(browserMessageBuilder()->getSharedKey(PUBLICKEY, "").empty());
+    QVERIFY(browserMessageBuilder()->getSharedKey("AAAA", SERVERSECRETKEY).empty());
+
+    // Same result as the full key agreement on every message
+    const auto encrypted = browserMessageBuilder()->encryptMessage(message, NONCE, sharedKey);
+    QCOMPARE(encrypted, QString("+zjtntnk4rGWSl/Ph7Vqip/swvgeupk4lNgHEm2OO3ujNr0OMz6eQtGwjtsj+/rP"));
+    QCOMPARE(browserMessageBuilder()->decryptMessage(encrypted, NONCE, sharedKey)["action"].toString(),
+             QString("test-action"));
+    QVERIFY(browserMessageBuilder()->decryptMessage(encrypted, INCREMENTEDNONCE, sharedKey).isEmpty());
+
+    // The action recomputes its shared key when the keys change
+    m_browserAction->m_secretKey = SERVERSECRETKEY;
+    m_browserAction->m_clientPublicKey = PUBLICKEY;
+    QCOMPARE(m_browserAction->decryptMessage(encrypted, NONCE)["action"].toString(), QString("test-action"));
+
+    const auto keyPair = browserMessageBuilder()->getKeyPair();
+    m_browserAction->m_secretKey = keyPair.second;
+    QVERIFY(m_browserAction->decryptMessage(encrypted, NONCE).isEmpty());
+}
+
 void TestBrowser::testGetBase64FromKey()
 {
     unsigned char pk[crypto_box_PUBLICKEYBYTES];
@@ -400,6 +427,69 @@ void TestBrowser::testSearchEntriesWithAdditionalURLs()
     QCOMPARE(additionalResult[0]->url(), QString("https://github.com/"));
 }
 
+void TestBrowser::testSearchEntriesAfterChanges()
+{
+    auto db = QSharedPointer<Database>::create();
+    auto* root = db->rootGroup();
+
+    QStringList urls = {"https://github.com/", "https://www.example.com", "http://domain.com"};
+    auto entries = createEntries(urls, root);
+
+    auto result = m_browserService->searchEntries(db, "https://example.com", "https://example.com");
+    QCOMPARE(result.length(), 0);
+
+    // Changed URLs are found right away
+    entries[2]->setUrl("https://login.example.com");
+    result = m_browserService->searchEntries(db, "https://login.example.com", "https://login.example.com");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[2]);
+
+    entries[0]->attributes()->set(EntryAttributes::AdditionalUrlAttribute, "https://login.example.com");
+    result = m_browserService->searchEntries(db, "https://login.example.com", "https://login.example.com");
+    QCOMPARE(result.length(), 2);
+    QCOMPARE(result[0], entries[0]);
+    QCOMPARE(result[1], entries[2]);
+
+    entries[0]->attributes()->remove(EntryAttributes::AdditionalUrlAttribute);
+    result = m_browserService->searchEntries(db, "https://login.example.com", "https://login.example.com");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[2]);
+
+    // Changes made while modified signals are disabled, as during a merge, are indexed too
+    db->setEmitModified(false);
+    entries[0]->setUrl("https://merged.example.com");
+    db->setEmitModified(true);
+    result = m_browserService->searchEntries(db, "https://merged.example.com", "https://merged.example.com");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[0]);
+    entries[0]->setUrl("https://github.com/");
+
+    // Groups omitting the www subdomain
+    auto* group = new Group();
+    group->setParent(root);
+    group->setCustomDataTriState(BrowserService::OPTION_OMIT_WWW, Group::Enable);
+    entries[1]->setGroup(group);
+    result = m_browserService->searchEntries(db, "https://example.com", "https://example.com");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[1]);
+
+    // Hidden groups and entries moved to another database
+    group->setCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY, Group::Enable);
+    result = m_browserService->searchEntries(db, "https://example.com", "https://example.com");
+    QCOMPARE(result.length(), 0);
+
+    auto otherDb = QSharedPointer<Database>::create();
+    entries[2]->setGroup(otherDb->rootGroup());
+    result = m_browserService->searchEntries(db, "https://login.example.com", "https://login.example.com");
+    QCOMPARE(result.length(), 0);
+    result = m_browserService->searchEntries(otherDb, "https://login.example.com", "https://login.example.com");
+    QCOMPARE(result.length(), 1);
+
+    delete entries[2];
+    result = m_browserService->searchEntries(otherDb, "https://login.example.com", "https://login.example.com");
+    QCOMPARE(result.length(), 0);
+}
+
 void TestBrowser::testInvalidEntries()
 {
     auto db = QSharedPointer<Database>::create();
@@ -34,6 +34,7 @@ private slots:
     void testChangePublicKeys();
     void testEncryptMessage();
     void testDecryptMessage();
+    void testSharedKey();
     void testGetBase64FromKey();
     void testIncrementNonce();
     void testBuildResponse();
@@ -45,6 +46,7 @@ private slots:
     void testSearchEntriesByReference();
     void testSearchEntriesWithPort();
     void testSearchEntriesWithAdditionalURLs();
+    void testSearchEntriesAfterChanges();
     void testInvalidEntries();
     void testSubdomainsAndPaths();
     void testBestMatchingCredentials();
@@ -17,6 +17,7 @@
 
 #include "TestConfig.h"
 
+#include <QSettings>
 #include <QTest>
 
 #include "config-keepassx-tests.h"
@@ -41,3 +42,31 @@ void TestConfig::testUpgrade()
 
     tempFile.remove();
 }
+
+void TestConfig::testSnapshot()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    tempFile.close();
+    Config::createConfigFromFile(tempFile.fileName());
+
+    QCOMPARE(config()->get(Config::GUI_HidePasswords), config()->getDefault(Config::GUI_HidePasswords));
+
+    config()->set(Config::GUI_HidePasswords, false);
+    QVERIFY(!config()->get(Config::GUI_HidePasswords).toBool());
+    config()->remove(Config::GUI_HidePasswords);
+    QCOMPARE(config()->get(Config::GUI_HidePasswords), config()->getDefault(Config::GUI_HidePasswords));
+
+    // Changes written to the file by another instance show up after syncing
+    {
+        QSettings other(tempFile.fileName(), QSettings::IniFormat);
+        other.setValue("GUI/HideUsernames", true);
+    }
+    config()->sync();
+    QVERIFY(config()->get(Config::GUI_HideUsernames).toBool());
+
+    config()->resetToDefaults();
+    QCOMPARE(config()->get(Config::GUI_HideUsernames), config()->getDefault(Config::GUI_HideUsernames));
+
+    tempFile.remove();
+}
@@ -19,6 +19,7 @@
 #include "TestCsvParser.h"
 
 #include <QTest>
+#include <QTextStream>
 
 QTEST_GUILESS_MAIN(TestCsvParser)
 
@@ -37,6 +38,7 @@ void TestCsvParser::init()
     parser->setComment('#');
     parser->setFieldSeparator(',');
     parser->setTextQualifier(QChar('"'));
+    parser->setMaxRows(0);
 }
 
 void TestCsvParser::cleanup()
@@ -344,3 +346,66 @@ void TestCsvParser::testUnicode()
     QVERIFY(t.at(0).at(2) == "3śAż");
     QVERIFY(t.at(0).at(3) == "żac");
 }
+
+void TestCsvParser::testMaxRows()
+{
+    parser->setMaxRows(2);
+    QTextStream out(file.data());
+    out << "1,2\n"
+        << "3,4\n"
+        << "5,6,7\n";
+    QVERIFY(parser->parse(file.data()));
+    t = parser->getCsvTable();
+    QCOMPARE(t.size(), 2);
+    QCOMPARE(parser->getCsvRows(), 2);
+    QCOMPARE(parser->getTotalRows(), 3);
+    // columns are counted over all rows, not just the kept ones
+    QCOMPARE(parser->getCsvCols(), 3);
+    QCOMPARE(t.at(1).at(2), QString(""));
+}
+
+void TestCsvParser::testForEachRow()
+{
+    parser->setMaxRows(1);
+    QTextStream out(file.data());
+    out << "a,b\n"
+        << "# comment\n"
+        << "c,\"d\ne\"\n"
+        << "f,g,h\n";
+    QVERIFY(parser->parse(file.data()));
+
+    CsvTable rows;
+    QVERIFY(parser->forEachRow([&](const CsvRow& row) { rows.append(row); }));
+    QCOMPARE(rows.size(), 3);
+    QCOMPARE(rows.at(0), CsvRow({"a", "b", ""}));
+    QCOMPARE(rows.at(1), CsvRow({"c", "d\ne", ""}));
+    QCOMPARE(rows.at(2), CsvRow({"f", "g", "h"}));
+
+    // the preview table is left untouched
+    t = parser->getCsvTable();
+    QCOMPARE(t.size(), 1);
+    QCOMPARE(t.at(0).at(0), QString("a"));
+}
+
+void TestCsvParser::testChunkBoundaries()
+{
+    // Place a CRLF pair and a multi-byte character across the boundaries
+    // of the chunks the file is read in
+    QByteArray data;
+    data.append(QByteArray(CsvParser::ChunkSize - 4, 'x'));
+    data.append("1,2\r\n\"3\r\n4\",5\n");
+    const int padding = CsvParser::ChunkSize - data.size() % CsvParser::ChunkSize - 1;
+    data.append(QByteArray(padding, 'y'));
+    data.append(QString("\u20AC,6").toUtf8());
+    QCOMPARE(file->write(data), qint64(data.size()));
+
+    QVERIFY(parser->parse(file.data()));
+    t = parser->getCsvTable();
+    QCOMPARE(t.size(), 3);
+    QCOMPARE(t.at(0).at(0), QString(QByteArray(CsvParser::ChunkSize - 4, 'x').append("1")));
+    QCOMPARE(t.at(0).at(1), QString("2"));
+    QCOMPARE(t.at(1).at(0), QString("3\n4"));
+    QCOMPARE(t.at(1).at(1), QString("5"));
+    QCOMPARE(t.at(2).at(0), QString(QByteArray(padding, 'y')).append(QChar(0x20AC)));
+    QCOMPARE(t.at(2).at(1), QString("6"));
+}
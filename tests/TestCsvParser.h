@@ -57,6 +57,9 @@ private slots:
     void testQuoted();
     void testMultiline();
     void testColumns();
+    void testMaxRows();
+    void testForEachRow();
+    void testChunkBoundaries();
 
 private:
     QScopedPointer<QTemporaryFile> file;
@@ -21,6 +21,7 @@
 #include <QRegularExpression>
 #include <QSignalSpy>
 #include <QTest>
+#include <QTimer>
 
 #include "config-keepassx-tests.h"
 #include "core/Group.h"
@@ -127,6 +128,198 @@ void TestDatabase::testSaveAs()
     QCOMPARE(error, QString("Could not save, database has not been initialized!"));
 }
 
+void TestDatabase::testPreparedKeyTransformation()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    // Save with a key prepared in the background
+    auto oldSeed = db->kdf()->seed();
+    db->prepareNextKeyTransformation();
+    db->metadata()->setName("prepared");
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(db->kdf()->seed() != oldSeed);
+
+    QByteArray expectedKey;
+    QVERIFY(key->transform(*db->kdf(), expectedKey));
+    QCOMPARE(db->transformedDatabaseKey(), expectedKey);
+
+    // A prepared key must be discarded if the KDF settings changed in the meantime
+    db->prepareNextKeyTransformation();
+    auto kdf = db->kdf()->clone();
+    kdf->setRounds(kdf->rounds() + 1);
+    QVERIFY(db->changeKdf(kdf));
+    db->metadata()->setName("changed kdf");
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(key->transform(*db->kdf(), expectedKey));
+    QCOMPARE(db->transformedDatabaseKey(), expectedKey);
+
+    // The saved file can be opened with the original key
+    auto reopened = QSharedPointer<Database>::create();
+    QVERIFY2(reopened->open(tempFile.fileName(), key, &error), error.toLatin1());
+    QCOMPARE(reopened->metadata()->name(), QString("changed kdf"));
+}
+
+void TestDatabase::testModifiedWhileSaving()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    auto entry = new Entry();
+    entry->setTitle("saved");
+    entry->setGroup(db->rootGroup());
+    db->metadata()->setName("saved");
+
+    // Modify the database from the event loop running while the snapshot is written
+    QTimer::singleShot(0, db.data(), [&] {
+        QVERIFY(db->isSaving());
+        entry->setTitle("modified while saving");
+        db->metadata()->setName("modified while saving");
+    });
+    QSignalSpy spySaved(db.data(), SIGNAL(databaseSaved()));
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QCOMPARE(spySaved.count(), 1);
+    QVERIFY(db->isModified());
+
+    auto reopened = QSharedPointer<Database>::create();
+    QVERIFY2(reopened->open(tempFile.fileName(), key, &error), error.toLatin1());
+    QCOMPARE(reopened->metadata()->name(), QString("saved"));
+    QVERIFY(reopened->rootGroup()->findEntryByUuid(entry->uuid()));
+    QCOMPARE(reopened->rootGroup()->findEntryByUuid(entry->uuid())->title(), QString("saved"));
+
+    // The changes are written by the next save
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+    QVERIFY(!db->isModified());
+
+    reopened = QSharedPointer<Database>::create();
+    QVERIFY2(reopened->open(tempFile.fileName(), key, &error), error.toLatin1());
+    QCOMPARE(reopened->metadata()->name(), QString("modified while saving"));
+    QCOMPARE(reopened->rootGroup()->findEntryByUuid(entry->uuid())->title(), QString("modified while saving"));
+}
+
+void TestDatabase::testSaveKeepsLocationChanged()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    const QDateTime locationChanged(QDate(2010, 1, 2), QTime(3, 4, 5), Qt::UTC);
+
+    auto group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setName("group");
+    group->setParent(db->rootGroup());
+    auto subgroup = new Group();
+    subgroup->setUuid(QUuid::createUuid());
+    subgroup->setName("subgroup");
+    subgroup->setParent(group);
+
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("entry");
+    entry->setGroup(subgroup);
+
+    for (auto g : {group, subgroup}) {
+        auto timeInfo = g->timeInfo();
+        timeInfo.setLocationChanged(locationChanged);
+        g->setTimeInfo(timeInfo);
+    }
+    auto timeInfo = entry->timeInfo();
+    timeInfo.setLocationChanged(locationChanged);
+    entry->setTimeInfo(timeInfo);
+
+    QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+
+    auto reopened = QSharedPointer<Database>::create();
+    QVERIFY2(reopened->open(tempFile.fileName(), key, &error), error.toLatin1());
+
+    const auto groups = db->rootGroup()->groupsRecursive(false);
+    QCOMPARE(reopened->rootGroup()->groupsRecursive(false).size(), groups.size());
+    for (auto g : groups) {
+        auto reopenedGroup = reopened->rootGroup()->findGroupByUuid(g->uuid());
+        QVERIFY(reopenedGroup);
+        QCOMPARE(reopenedGroup->timeInfo().locationChanged(), g->timeInfo().locationChanged());
+    }
+
+    const auto entries = db->rootGroup()->entriesRecursive(false);
+    QCOMPARE(reopened->rootGroup()->entriesRecursive(false).size(), entries.size());
+    for (auto e : entries) {
+        auto reopenedEntry = reopened->rootGroup()->findEntryByUuid(e->uuid());
+        QVERIFY(reopenedEntry);
+        QCOMPARE(reopenedEntry->timeInfo().locationChanged(), e->timeInfo().locationChanged());
+    }
+
+    QCOMPARE(reopened->rootGroup()->findGroupByUuid(subgroup->uuid())->timeInfo().locationChanged(),
+             locationChanged);
+    QCOMPARE(reopened->rootGroup()->findEntryByUuid(entry->uuid())->timeInfo().locationChanged(), locationChanged);
+}
+
+void TestDatabase::benchmarkSaveSnapshot_data()
+{
+    QTest::addColumn<int>("entries");
+    QTest::addColumn<int>("history");
+
+    QTest::newRow("1000 entries") << 1000 << 0;
+    QTest::newRow("10000 entries") << 10000 << 0;
+    QTest::newRow("10000 entries, 10 history items") << 10000 << 10;
+}
+
+void TestDatabase::benchmarkSaveSnapshot()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(int, entries);
+    QFETCH(int, history);
+
+    Database db;
+    db.setEmitModified(false);
+    for (int i = 0; i < entries; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(db.rootGroup());
+        entry->setUpdateTimeinfo(false);
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUsername(QString("user%1").arg(i));
+        entry->setUrl(QString("https://example%1.com").arg(i));
+        entry->setNotes(QString(256, 'n'));
+        for (int j = 0; j < history; ++j) {
+            entry->setPassword(QString("password %1 %2").arg(i).arg(j));
+            entry->addHistoryItem(entry->clone(Entry::CloneNoFlags));
+        }
+        entry->setPassword(QString("password %1").arg(i));
+    }
+
+    // Cost paid on the GUI thread before the worker starts writing
+    QBENCHMARK
+    {
+        auto snapshot = db.createSaveSnapshot();
+        QCOMPARE(snapshot->rootGroup()->entries().size(), entries);
+    }
+}
+
 void TestDatabase::testSignals()
 {
     TemporaryFile tempFile;
@@ -257,3 +450,34 @@ void TestDatabase::testCustomIcons()
     QCOMPARE(iconData.name, QString("Test"));
     QCOMPARE(iconData.lastModified, date);
 }
+
+void TestDatabase::testDestroyWithIndexedData()
+{
+    // Groups and entries leave the database indexes when the database is destroyed,
+    // this must not touch members that are already gone (caught by WITH_ASAN builds)
+    auto db = new Database();
+    auto group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setParent(db->rootGroup());
+
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("title");
+    entry->setUrl("https://example.com");
+    entry->setPassword("password");
+    AutoTypeAssociations::Association association;
+    association.window = "* - Example";
+    entry->autoTypeAssociations()->add(association);
+    entry->setGroup(group);
+
+    QPointer<Group> rootGroup = db->rootGroup();
+    delete db;
+    QVERIFY(rootGroup.isNull());
+
+    // A database that was cleared before being destroyed
+    db = new Database();
+    db->releaseData();
+    rootGroup = db->rootGroup();
+    delete db;
+    QVERIFY(rootGroup.isNull());
+}
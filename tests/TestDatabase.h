@@ -30,12 +30,18 @@ private slots:
     void testOpen();
     void testSave();
     void testSaveAs();
+    void testPreparedKeyTransformation();
+    void testModifiedWhileSaving();
+    void testSaveKeepsLocationChanged();
+    void benchmarkSaveSnapshot_data();
+    void benchmarkSaveSnapshot();
     void testSignals();
     void testEmptyRecycleBinOnDisabled();
     void testEmptyRecycleBinOnNotCreated();
     void testEmptyRecycleBinOnEmpty();
     void testEmptyRecycleBinWithHierarchicalData();
     void testCustomIcons();
+    void testDestroyWithIndexedData();
 };
 
 #endif // KEEPASSX_TESTDATABASE_H
@@ -511,6 +511,128 @@ void TestEntry::testResolveNonIdPlaceholdersToUuid()
     }
 }
 
+void TestEntry::testResolveReferenceIndex()
+{
+    Database db;
+    auto* root = db.rootGroup();
+
+    auto* group = new Group();
+    group->setParent(root);
+    auto* entryInGroup = new Entry();
+    entryInGroup->setGroup(group);
+    entryInGroup->setUuid(QUuid::createUuid());
+    entryInGroup->setTitle("Duplicate");
+    entryInGroup->setPassword("GroupPassword");
+
+    auto* entryInRoot = new Entry();
+    entryInRoot->setGroup(root);
+    entryInRoot->setUuid(QUuid::createUuid());
+    entryInRoot->setTitle("Duplicate");
+    entryInRoot->setPassword("RootPassword");
+
+    auto* referencingEntry = new Entry();
+    referencingEntry->setGroup(root);
+    referencingEntry->setUuid(QUuid::createUuid());
+    referencingEntry->setPassword("{REF:P@T:Duplicate}");
+
+    // Entries of a group are found before the entries of its subgroups
+    QCOMPARE(root->findEntryBySearchTerm("Duplicate", EntryReferenceType::Title), entryInRoot);
+    QCOMPARE(group->findEntryBySearchTerm("Duplicate", EntryReferenceType::Title), entryInGroup);
+    QCOMPARE(referencingEntry->resolveMultiplePlaceholders(referencingEntry->password()), QString("RootPassword"));
+    QCOMPARE(root->findEntryBySearchTerm(entryInGroup->uuidToHex(), EntryReferenceType::QUuid), entryInGroup);
+    QVERIFY(!group->findEntryBySearchTerm(entryInRoot->uuidToHex(), EntryReferenceType::QUuid));
+
+    // Changed values are picked up immediately
+    entryInRoot->setTitle("Renamed");
+    QCOMPARE(root->findEntryBySearchTerm("Duplicate", EntryReferenceType::Title), entryInGroup);
+    QCOMPARE(root->findEntryBySearchTerm("Renamed", EntryReferenceType::Title), entryInRoot);
+    QCOMPARE(referencingEntry->resolveMultiplePlaceholders(referencingEntry->password()), QString("GroupPassword"));
+
+    entryInRoot->setUsername("Username");
+    QCOMPARE(root->findEntryBySearchTerm("Username", EntryReferenceType::UserName), entryInRoot);
+    entryInRoot->attributes()->set(EntryAttributes::UserNameKey, "Other");
+    QVERIFY(!root->findEntryBySearchTerm("Username", EntryReferenceType::UserName));
+    QCOMPARE(root->findEntryBySearchTerm("Other", EntryReferenceType::UserName), entryInRoot);
+
+    // Changes made while modified signals are disabled, as during a merge or load, are indexed too
+    db.setEmitModified(false);
+    entryInRoot->setPassword("Unsignaled");
+    QCOMPARE(root->findEntryBySearchTerm("Unsignaled", EntryReferenceType::Password), entryInRoot);
+    QVERIFY(!root->findEntryBySearchTerm("RootPassword", EntryReferenceType::Password));
+    db.setEmitModified(true);
+
+    // Entries leaving the database are no longer found
+    auto* detachedGroup = new Group();
+    entryInGroup->setGroup(detachedGroup);
+    QVERIFY(!root->findEntryBySearchTerm("Duplicate", EntryReferenceType::Title));
+    QCOMPARE(detachedGroup->findEntryBySearchTerm("Duplicate", EntryReferenceType::Title), entryInGroup);
+    QCOMPARE(referencingEntry->resolveMultiplePlaceholders(referencingEntry->password()), QString());
+
+    entryInGroup->setGroup(group);
+    QCOMPARE(root->findEntryBySearchTerm("Duplicate", EntryReferenceType::Title), entryInGroup);
+    delete detachedGroup;
+
+    delete entryInGroup;
+    QVERIFY(!root->findEntryBySearchTerm("Duplicate", EntryReferenceType::Title));
+    QVERIFY(!root->findEntryBySearchTerm("GroupPassword", EntryReferenceType::Password));
+}
+
+void TestEntry::testResolvePlaceholderCache()
+{
+    Database db;
+    auto* root = db.rootGroup();
+
+    auto* group = new Group();
+    group->setParent(root);
+    auto* entry1 = new Entry();
+    entry1->setGroup(group);
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setTitle("Title1");
+    entry1->setPassword("Password1");
+
+    auto* entry2 = new Entry();
+    entry2->setGroup(root);
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setUsername("Username2");
+    entry2->setPassword(QString("{REF:P@I:%1}").arg(entry1->uuidToHex()));
+    entry2->setNotes("{USERNAME} {REF:U@T:Title1}");
+
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->password()), QString("Password1"));
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->password()), QString("Password1"));
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->notes()), QString("Username2 "));
+
+    // Changes to the referenced entry
+    entry1->setPassword("Password1 updated");
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->password()), QString("Password1 updated"));
+    entry1->setUsername("Username1");
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->notes()), QString("Username2 Username1"));
+
+    // Changes to the entry itself
+    entry2->setUsername("Username2 updated");
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->notes()), QString("Username2 updated Username1"));
+
+    // Another entry starts matching the reference
+    auto* entry3 = new Entry();
+    entry3->setGroup(root);
+    entry3->setUuid(QUuid::createUuid());
+    entry3->setUsername("Username3");
+    entry3->setTitle("Title1");
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->notes()), QString("Username2 updated Username3"));
+
+    // The referenced entry goes away
+    delete entry3;
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->notes()), QString("Username2 updated Username1"));
+    delete entry1;
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->password()), QString());
+    QCOMPARE(entry2->resolveMultiplePlaceholders(entry2->notes()), QString("Username2 updated "));
+
+    // Time based placeholders are resolved on every call
+    entry2->setTitle("{DT_UTC_SIMPLE}");
+    const QString resolvedTime = entry2->resolveMultiplePlaceholders(entry2->title());
+    QTest::qSleep(1100);
+    QVERIFY(entry2->resolveMultiplePlaceholders(entry2->title()) != resolvedTime);
+}
+
 void TestEntry::testResolveClonedEntry()
 {
     Database db;
@@ -394,3 +394,155 @@ void TestEntrySearcher::testUUIDSearch()
     m_searchResult = m_entrySearcher.search("uuid:" + Tools::uuidToHex(uuid1), m_rootGroup);
     QCOMPARE(m_searchResult.count(), 1);
 }
+
+void TestEntrySearcher::testIncrementalSearch()
+{
+    auto e1 = new Entry();
+    e1->setTitle("alpha beta");
+    e1->setGroup(m_rootGroup);
+
+    auto e2 = new Entry();
+    e2->setTitle("alpine");
+    e2->setGroup(m_rootGroup);
+
+    // Tags are matched exactly, so these only match once the whole tag was typed
+    auto e3 = new Entry();
+    e3->setTags("alp");
+    e3->setGroup(m_rootGroup);
+
+    auto e4 = new Entry();
+    e4->setTags("alpha");
+    e4->setGroup(m_rootGroup);
+
+    m_searchResult = m_entrySearcher.searchIncremental("al", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1, e2}));
+
+    m_searchResult = m_entrySearcher.searchIncremental("alp", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1, e2, e3}));
+
+    m_searchResult = m_entrySearcher.searchIncremental("alpha", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1, e4}));
+
+    // Additional terms narrow down the results
+    m_searchResult = m_entrySearcher.searchIncremental("alpha be", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1}));
+
+    // Shorter words widen the search again
+    m_searchResult = m_entrySearcher.searchIncremental("alp", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1, e2, e3}));
+
+    // Excluded terms must not be refined
+    m_searchResult = m_entrySearcher.searchIncremental("alp -b", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e3}));
+    m_searchResult = m_entrySearcher.searchIncremental("alp -be", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e3}));
+    m_searchResult = m_entrySearcher.searchIncremental("alp -bea", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2, e3}));
+
+    // Results are only refreshed after clearing the cache
+    m_searchResult = m_entrySearcher.searchIncremental("alpi", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2}));
+    e1->setTitle("alpine beta");
+    m_searchResult = m_entrySearcher.searchIncremental("alpin", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e2}));
+    m_entrySearcher.clearCache();
+    m_searchResult = m_entrySearcher.searchIncremental("alpin", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1, e2}));
+
+    // Deleted entries are dropped from the cached results
+    delete e2;
+    m_searchResult = m_entrySearcher.searchIncremental("alpine", m_rootGroup);
+    QCOMPARE(m_searchResult, QList<Entry*>({e1}));
+}
+
+void TestEntrySearcher::testSnapshotSearch()
+{
+    const int count = EntrySearcher::SnapshotBatchSize * 2 + 10;
+    for (int i = 0; i < count; ++i) {
+        auto entry = new Entry();
+        entry->setTitle(QString("entry %1").arg(i));
+        entry->setUsername(i % 2 ? "odd" : "even");
+        entry->setGroup(m_rootGroup);
+    }
+
+    auto snapshot = EntrySearcher::takeSnapshot(m_rootGroup, "u:odd");
+    QCOMPARE(snapshot->size(), count);
+
+    auto resolve = [&](const QList<int>& indices) {
+        QList<Entry*> entries;
+        for (int index : indices) {
+            entries.append(snapshot->at(index).entry);
+        }
+        return entries;
+    };
+
+    // Results are reported in batches and match a regular search
+    QList<int> matches;
+    int batches = 0;
+    auto collect = [&](const QList<int>& batch) {
+        matches.append(batch);
+        ++batches;
+        return true;
+    };
+    QVERIFY(m_entrySearcher.searchSnapshot("u:odd", snapshot, collect));
+    QCOMPARE(batches, 3);
+    QCOMPARE(resolve(matches), m_entrySearcher.search("u:odd", m_rootGroup));
+
+    // Narrowing the search refines the previous results
+    matches.clear();
+    QVERIFY(m_entrySearcher.searchSnapshot("u:odd entry 1", snapshot, collect));
+    QCOMPARE(resolve(matches), m_entrySearcher.search("u:odd entry 1", m_rootGroup));
+
+    // The snapshot does not see later modifications
+    m_rootGroup->entries().first()->setUsername("odd");
+    matches.clear();
+    QVERIFY(m_entrySearcher.searchSnapshot("u:odd", snapshot, collect));
+    QCOMPARE(matches.size(), count / 2);
+
+    // A search can be cancelled between batches
+    matches.clear();
+    QVERIFY(!m_entrySearcher.searchSnapshot("entry", snapshot, [&](const QList<int>& batch) {
+        matches.append(batch);
+        return false;
+    }));
+    QCOMPARE(matches.size(), static_cast<int>(EntrySearcher::SnapshotBatchSize));
+
+    // Weak password checks need the live entries
+    QVERIFY(EntrySearcher::canSearchSnapshot("u:odd"));
+    QVERIFY(!EntrySearcher::canSearchSnapshot("is:weak"));
+}
+
+void TestEntrySearcher::testSnapshotSensitiveFields()
+{
+    auto entry = new Entry();
+    entry->setTitle("title");
+    entry->setPassword("secret");
+    entry->attributes()->set("PIN", "1234", true);
+    entry->attributes()->set("Other", "value", true);
+    entry->setGroup(m_rootGroup);
+
+    // Passwords and attribute values are left out unless the search looks at them
+    auto snapshot = EntrySearcher::takeSnapshot(m_rootGroup, "title");
+    QCOMPARE(snapshot->size(), 1);
+    QVERIFY(snapshot->at(0).password.isEmpty());
+    QVERIFY(snapshot->at(0).attributes.isEmpty());
+    QVERIFY(snapshot->at(0).customAttributes.isEmpty());
+    QVERIFY(EntrySearcher::snapshotCovers(*snapshot, "title"));
+    QVERIFY(!EntrySearcher::snapshotCovers(*snapshot, "pw:secret"));
+    QVERIFY(!EntrySearcher::snapshotCovers(*snapshot, "attr:PIN"));
+    QVERIFY(!EntrySearcher::snapshotCovers(*snapshot, "_PIN:1234"));
+
+    snapshot = EntrySearcher::takeSnapshot(m_rootGroup, "pw:secret _PIN:1234");
+    QCOMPARE(snapshot->at(0).password, QString("secret"));
+    QCOMPARE(snapshot->at(0).attributes.keys(), QStringList{"PIN"});
+    QVERIFY(EntrySearcher::snapshotCovers(*snapshot, "pw:sec"));
+    QVERIFY(!EntrySearcher::snapshotCovers(*snapshot, "_Other:value"));
+
+    QList<int> matches;
+    auto collect = [&](const QList<int>& batch) {
+        matches.append(batch);
+        return true;
+    };
+    QVERIFY(m_entrySearcher.searchSnapshot("pw:secret _PIN:1234", snapshot, collect));
+    QCOMPARE(matches, QList<int>{0});
+}
@@ -39,6 +39,9 @@ private slots:
     void testGroup();
     void testSkipProtected();
     void testUUIDSearch();
+    void testIncrementalSearch();
+    void testSnapshotSearch();
+    void testSnapshotSensitiveFields();
 
 private:
     Group* m_rootGroup;
@@ -17,10 +17,8 @@
 
 #include "TestFdoSecrets.h"
 
-#include "core/EntrySearcher.h"
-#include "core/Group.h"
 #include "crypto/Random.h"
-#include "fdosecrets/objects/Collection.h"
+#include "fdosecrets/dbus/DBusMgr.h"
 #include "fdosecrets/objects/SessionCipher.h"
 
 #include <QTest>
@@ -33,62 +31,6 @@ void TestFdoSecrets::testDhIetf1024Sha256Aes128CbcPkcs7()
     QVERIFY(cipher.isValid());
 }
 
-void TestFdoSecrets::testCrazyAttributeKey()
-{
-    using FdoSecrets::Collection;
-    using FdoSecrets::Item;
-
-    const QScopedPointer<Group> root(new Group());
-    const QScopedPointer<Entry> e1(new Entry());
-    e1->setGroup(root.data());
-
-    const QString key = "_a:bc&-+'-e%12df_d";
-    const QString value = "value";
-    e1->attributes()->set(key, value);
-
-    // search for custom entries
-    const auto term = Collection::attributeToTerm(key, value);
-    const auto res = EntrySearcher().search({term}, root.data());
-    QCOMPARE(res.count(), 1);
-}
-
-void TestFdoSecrets::testSpecialCharsInAttributeValue()
-{
-    using FdoSecrets::Collection;
-    using FdoSecrets::Item;
-
-    const QScopedPointer<Group> root(new Group());
-    QScopedPointer<Entry> e1(new Entry());
-    e1->setGroup(root.data());
-
-    e1->setTitle("titleA");
-    e1->attributes()->set("testAttribute", "OAuth::[test.name@gmail.com]");
-
-    QScopedPointer<Entry> e2(new Entry());
-    e2->setGroup(root.data());
-    e2->setTitle("titleB");
-    e2->attributes()->set("testAttribute", "Abc:*+.-");
-
-    // search for custom entries via programmatic API
-    {
-        const auto term = Collection::attributeToTerm("testAttribute", "OAuth::[test.name@gmail.com]");
-        const auto res = EntrySearcher().search({term}, root.data());
-        QCOMPARE(res.count(), 1);
-        QCOMPARE(res[0]->title(), QStringLiteral("titleA"));
-    }
-    {
-        const auto term = Collection::attributeToTerm("testAttribute", "Abc:*+.-");
-        const auto res = EntrySearcher().search({term}, root.data());
-        QCOMPARE(res.count(), 1);
-        QCOMPARE(res[0]->title(), QStringLiteral("titleB"));
-    }
-    {
-        const auto term = Collection::attributeToTerm("testAttribute", "v|");
-        const auto res = EntrySearcher().search({term}, root.data());
-        QCOMPARE(res.count(), 0);
-    }
-}
-
 void TestFdoSecrets::testDBusPathParse()
 {
     using FdoSecrets::DBusMgr;
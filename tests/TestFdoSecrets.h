@@ -26,8 +26,6 @@ class TestFdoSecrets : public QObject
 
 private slots:
     void testDhIetf1024Sha256Aes128CbcPkcs7();
-    void testCrazyAttributeKey();
-    void testSpecialCharsInAttributeValue();
     void testDBusPathParse();
 };
 
@@ -0,0 +1,195 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestFileCopy.h"
+
+#include "core/FileCopy.h"
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(TestFileCopy)
+
+Q_DECLARE_METATYPE(FileCopy::Method)
+
+namespace
+{
+    QByteArray createFile(const QString& path, int size)
+    {
+        QByteArray data(size, Qt::Uninitialized);
+        for (int i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(i * 7 + i / 4096);
+        }
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != size) {
+            return {};
+        }
+        return data;
+    }
+
+    QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return {};
+        }
+        return file.readAll();
+    }
+
+    void addMethodRows()
+    {
+        QTest::addColumn<FileCopy::Method>("method");
+
+        QTest::newRow("Auto") << FileCopy::Method::Auto;
+        QTest::newRow("Reflink") << FileCopy::Method::Reflink;
+        QTest::newRow("CopyFileRange") << FileCopy::Method::CopyFileRange;
+        QTest::newRow("Buffered") << FileCopy::Method::Buffered;
+    }
+} // namespace
+
+void TestFileCopy::testCopy_data()
+{
+    addMethodRows();
+}
+
+void TestFileCopy::testCopy()
+{
+    QFETCH(FileCopy::Method, method);
+    if (!FileCopy::isSupported(method)) {
+        QSKIP("Copy method is not supported on this platform.");
+    }
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    auto source = tempDir.filePath("source");
+    auto destination = tempDir.filePath("destination");
+
+    auto data = createFile(source, 3 * 1024 * 1024 + 17);
+    QVERIFY(!data.isEmpty());
+
+    FileCopy::Method usedMethod;
+    if (!FileCopy::copy(source, destination, method, &usedMethod)) {
+        // Reflinks and in-kernel copies depend on the file system
+        QVERIFY(method == FileCopy::Method::Reflink || method == FileCopy::Method::CopyFileRange);
+        QVERIFY(!QFile::exists(destination));
+        QSKIP("Copy method is not supported by the file system.");
+    }
+    QVERIFY(usedMethod != FileCopy::Method::Auto);
+    if (method != FileCopy::Method::Auto) {
+        QCOMPARE(usedMethod, method);
+    }
+    QCOMPARE(readFile(destination), data);
+
+    // Existing files are never overwritten
+    createFile(source, 16);
+    QVERIFY(!FileCopy::copy(source, destination, method));
+    QCOMPARE(readFile(destination), data);
+
+    // Missing source files are an error
+    QVERIFY(!FileCopy::copy(tempDir.filePath("missing"), tempDir.filePath("other"), method));
+    QVERIFY(!QFile::exists(tempDir.filePath("other")));
+}
+
+void TestFileCopy::testEmptyFile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    auto source = tempDir.filePath("empty");
+    QVERIFY(createFile(source, 0).isEmpty());
+    QVERIFY(QFile::exists(source));
+
+    // Empty files are copied by any method
+    QVERIFY(FileCopy::copy(source, tempDir.filePath("copy")));
+    QVERIFY(QFile::exists(tempDir.filePath("copy")));
+    QCOMPARE(QFileInfo(tempDir.filePath("copy")).size(), 0);
+}
+
+void TestFileCopy::testShortCopy()
+{
+#ifdef Q_OS_LINUX
+    if (!FileCopy::isSupported(FileCopy::Method::CopyFileRange)) {
+        QSKIP("Copy method is not supported on this platform.");
+    }
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    auto data = createFile(tempDir.filePath("source"), 4096);
+    QVERIFY(!data.isEmpty());
+
+    QFile source(tempDir.filePath("source"));
+    QVERIFY(source.open(QIODevice::ReadOnly));
+    QFile destination(tempDir.filePath("destination"));
+    QVERIFY(destination.open(QIODevice::WriteOnly));
+    if (!FileCopy::copyFileRange(source.handle(), destination.handle(), data.size())) {
+        QSKIP("Copy method is not supported by the file system.");
+    }
+    destination.close();
+    QCOMPARE(readFile(tempDir.filePath("destination")), data);
+
+    // A source that ends before the expected size, as if it was truncated while copying
+    QFile shortSource(tempDir.filePath("source"));
+    QVERIFY(shortSource.open(QIODevice::ReadOnly));
+    QFile shortDestination(tempDir.filePath("short"));
+    QVERIFY(shortDestination.open(QIODevice::WriteOnly));
+    QVERIFY(!FileCopy::copyFileRange(shortSource.handle(), shortDestination.handle(), data.size() + 1024));
+#else
+    QSKIP("Copy method is not supported on this platform.");
+#endif
+}
+
+void TestFileCopy::benchmarkCopy_data()
+{
+    addMethodRows();
+}
+
+void TestFileCopy::benchmarkCopy()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(FileCopy::Method, method);
+    if (!FileCopy::isSupported(method)) {
+        QSKIP("Copy method is not supported on this platform.");
+    }
+
+    // Copy next to the source like a database backup, set TMPDIR to benchmark another file system
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    auto source = tempDir.filePath("source.kdbx");
+    const int size = 100 * 1024 * 1024;
+    QVERIFY(!createFile(source, size).isEmpty());
+
+    auto destination = tempDir.filePath("backup.kdbx");
+    FileCopy::Method usedMethod = FileCopy::Method::Auto;
+    if (!FileCopy::copy(source, destination, method, &usedMethod)) {
+        QSKIP("Copy method is not supported by the file system.");
+    }
+
+    QBENCHMARK
+    {
+        QFile::remove(destination);
+        QVERIFY(FileCopy::copy(source, destination, method));
+    }
+
+    // Only buffered copies move the data through this process
+    auto copiedBytes = usedMethod == FileCopy::Method::Buffered ? size : 0;
+    qInfo("Bytes read and written by the process per backup: %d of %d", copiedBytes, size);
+}
@@ -0,0 +1,169 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestFileWatcher.h"
+
+#include "core/FileWatcher.h"
+
+#include <QSaveFile>
+#include <QSignalSpy>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(TestFileWatcher)
+
+void TestFileWatcher::init()
+{
+    m_tempDir.reset(new QTemporaryDir());
+    QVERIFY(m_tempDir->isValid());
+    m_filePath = m_tempDir->filePath("watched.kdbx");
+    writeFile("initial contents");
+}
+
+QString TestFileWatcher::writeFile(const QByteArray& data)
+{
+    // Write in place, keeping the inode
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+        return file.errorString();
+    }
+    return {};
+}
+
+void TestFileWatcher::testInotify()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("inotify is only available on Linux");
+#endif
+    FileWatcher watcher;
+    watcher.start(m_filePath);
+    if (watcher.m_polling) {
+        QSKIP("The temporary directory is on a network file system");
+    }
+    QVERIFY(watcher.m_inotifyFd >= 0);
+    QSignalSpy spyChanged(&watcher, SIGNAL(fileChanged(QString)));
+
+    // Atomic saves replace the file
+    QSaveFile saveFile(m_filePath);
+    QVERIFY(saveFile.open(QIODevice::WriteOnly));
+    saveFile.write("replaced contents");
+    QVERIFY(saveFile.commit());
+    QTRY_COMPARE(spyChanged.count(), 1);
+    QCOMPARE(spyChanged.takeFirst().at(0).toString(), m_filePath);
+
+    // Rewrites in place
+    QTRY_VERIFY(!watcher.m_fileChangeDelayTimer.isActive() && !watcher.m_ignoreFileChange);
+    QCOMPARE(writeFile("rewritten contents"), QString());
+    QTRY_COMPARE(spyChanged.count(), 1);
+    spyChanged.clear();
+
+    // Other files in the directory and unchanged contents are not reported
+    QTRY_VERIFY(!watcher.m_fileChangeDelayTimer.isActive() && !watcher.m_ignoreFileChange);
+    QFile other(m_tempDir->filePath("other.kdbx"));
+    QVERIFY(other.open(QIODevice::WriteOnly));
+    other.write("other");
+    other.close();
+    QCOMPARE(writeFile("rewritten contents"), QString());
+    QTest::qWait(200);
+    QCOMPARE(spyChanged.count(), 0);
+
+    // A file moved away and back is noticed
+    QVERIFY(QFile::rename(m_filePath, m_filePath + ".moved"));
+    QFile moved(m_filePath + ".moved");
+    QVERIFY(moved.open(QIODevice::Append));
+    moved.write(" and moved");
+    moved.close();
+    QVERIFY(QFile::rename(m_filePath + ".moved", m_filePath));
+    QTRY_COMPARE(spyChanged.count(), 1);
+
+    watcher.stop();
+    QCOMPARE(watcher.m_inotifyFd, -1);
+}
+
+void TestFileWatcher::testRacyRewrite()
+{
+    FileWatcher watcher;
+    watcher.start(m_filePath);
+    QVERIFY(watcher.hasSameFileChecksum());
+
+    // A rewrite within the timestamp granularity leaves the stamp as it was
+    QCOMPARE(writeFile("changed contents"), QString());
+    watcher.m_fileStamp = watcher.readFileStamp();
+
+    // The stamp was read right after the write, it cannot prove the contents unchanged
+    QVERIFY(watcher.m_fileStamp.isRacy());
+    QVERIFY(!watcher.hasSameFileChecksum());
+
+    // Stamps become trusted once the last write is older than the granularity
+    watcher.m_fileStamp.read += 10 * Q_INT64_C(1000000000);
+    QVERIFY(!watcher.m_fileStamp.isRacy());
+}
+
+void TestFileWatcher::testNetworkFileSystemPolling()
+{
+    FileWatcher watcher;
+    watcher.start(m_filePath, 30);
+    // Network file systems cannot be mounted here, switch to the same mode they use
+    watcher.startPolling(30);
+    QVERIFY(watcher.m_polling);
+    QCOMPARE(watcher.m_inotifyFd, -1);
+    QVERIFY(watcher.m_fileWatcher.files().isEmpty());
+    QVERIFY(watcher.m_fileChecksumTimer.isActive());
+    QCOMPARE(watcher.m_fileChecksumTimer.interval(), static_cast<int>(FileWatcher::MinPollIntervalMs));
+    QCOMPARE(watcher.m_maxPollIntervalMs, 30000);
+
+    QSignalSpy spyChanged(&watcher, SIGNAL(fileChanged(QString)));
+    QCOMPARE(writeFile("changed by another client"), QString());
+    QTRY_COMPARE_WITH_TIMEOUT(spyChanged.count(), 1, 5000);
+
+    // The stamp is never trusted without reading the file, the metadata may be cached
+    QVERIFY(watcher.hasSameFileChecksum());
+    QCOMPARE(writeFile("changed again by another client"), QString());
+    watcher.m_fileStamp = watcher.readFileStamp();
+    watcher.m_fileStamp.read += 10 * Q_INT64_C(1000000000);
+    QVERIFY(!watcher.hasSameFileChecksum());
+}
+
+void TestFileWatcher::testPollBackoff()
+{
+    FileWatcher watcher;
+    watcher.start(m_filePath);
+    watcher.startPolling(4);
+    QCOMPARE(watcher.m_maxPollIntervalMs, 4000);
+
+    // The interval doubles while the file is unchanged, up to the checksum interval
+    QList<int> intervals;
+    for (int i = 0; i < 4; ++i) {
+        watcher.updatePollInterval(false);
+        intervals << watcher.m_fileChecksumTimer.interval();
+    }
+    QCOMPARE(intervals, QList<int>({2000, 4000, 4000, 4000}));
+
+    // Changes reset it
+    watcher.updatePollInterval(true);
+    QCOMPARE(watcher.m_fileChecksumTimer.interval(), static_cast<int>(FileWatcher::MinPollIntervalMs));
+
+    // Without a checksum interval the default maximum applies
+    watcher.startPolling(0);
+    QCOMPARE(watcher.m_maxPollIntervalMs, static_cast<int>(FileWatcher::MaxPollIntervalMs));
+
+    // Watchers not polling keep their interval
+    watcher.start(m_filePath, 30);
+    if (!watcher.m_polling) {
+        watcher.updatePollInterval(false);
+        QCOMPARE(watcher.m_fileChecksumTimer.interval(), 30000);
+    }
+}
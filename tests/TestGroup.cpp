@@ -616,6 +616,130 @@ void TestGroup::testFindGroupByPath()
     QVERIFY(!group);
 }
 
+void TestGroup::testFindByUuidIndex()
+{
+    QScopedPointer<Database> db(new Database());
+    QScopedPointer<Database> otherDb(new Database());
+
+    auto group1 = new Group();
+    group1->setUuid(QUuid::createUuid());
+    group1->setParent(db->rootGroup());
+
+    auto group2 = new Group();
+    group2->setUuid(QUuid::createUuid());
+    group2->setParent(group1);
+
+    auto entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setGroup(group2);
+
+    auto entry2 = new Entry();
+    entry2->setGroup(db->rootGroup());
+    entry2->setUuid(QUuid::createUuid());
+
+    QCOMPARE(db->rootGroup()->findGroupByUuid(group2->uuid()), group2);
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry1->uuid()), entry1);
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry2->uuid()), entry2);
+
+    // Lookups are restricted to the subtree of the searched group
+    QCOMPARE(group1->findEntryByUuid(entry1->uuid()), entry1);
+    QVERIFY(!group1->findEntryByUuid(entry2->uuid()));
+    QVERIFY(!group1->findEntryByUuid(entry1->uuid(), false));
+    QCOMPARE(group2->findEntryByUuid(entry1->uuid(), false), entry1);
+    QVERIFY(!group2->findGroupByUuid(group1->uuid()));
+
+    // Changing a UUID updates the index
+    QUuid oldUuid = entry1->uuid();
+    entry1->setUuid(QUuid::createUuid());
+    QVERIFY(!db->rootGroup()->findEntryByUuid(oldUuid));
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry1->uuid()), entry1);
+
+    oldUuid = group2->uuid();
+    group2->setUuid(QUuid::createUuid());
+    QVERIFY(!db->rootGroup()->findGroupByUuid(oldUuid));
+    QCOMPARE(db->rootGroup()->findGroupByUuid(group2->uuid()), group2);
+
+    // Moving within the database keeps entries reachable
+    entry1->setGroup(db->rootGroup());
+    QCOMPARE(db->rootGroup()->findEntryByUuid(entry1->uuid()), entry1);
+    QVERIFY(!group1->findEntryByUuid(entry1->uuid()));
+
+    // Moving to another database transfers the whole subtree
+    entry1->setGroup(group2);
+    group1->setParent(otherDb->rootGroup());
+    QVERIFY(!db->rootGroup()->findGroupByUuid(group2->uuid()));
+    QVERIFY(!db->rootGroup()->findEntryByUuid(entry1->uuid()));
+    QCOMPARE(otherDb->rootGroup()->findGroupByUuid(group2->uuid()), group2);
+    QCOMPARE(otherDb->rootGroup()->findEntryByUuid(entry1->uuid()), entry1);
+
+    // Deleted items disappear from the index
+    QUuid entryUuid = entry1->uuid();
+    QUuid groupUuid = group2->uuid();
+    delete group1;
+    QVERIFY(!otherDb->rootGroup()->findGroupByUuid(groupUuid));
+    QVERIFY(!otherDb->rootGroup()->findEntryByUuid(entryUuid));
+
+    entryUuid = entry2->uuid();
+    delete entry2;
+    QVERIFY(!db->rootGroup()->findEntryByUuid(entryUuid));
+
+    // Groups outside of a database are still searched
+    Group detached;
+    auto detachedEntry = new Entry();
+    detachedEntry->setUuid(QUuid::createUuid());
+    detachedEntry->setGroup(&detached);
+    QCOMPARE(detached.findEntryByUuid(detachedEntry->uuid()), detachedEntry);
+}
+
+void TestGroup::testForEachRecursive()
+{
+    QScopedPointer<Database> db(new Database());
+    Group* root = db->rootGroup();
+
+    auto group1 = new Group();
+    group1->setParent(root);
+    auto group11 = new Group();
+    group11->setParent(group1);
+    auto group2 = new Group();
+    group2->setParent(root);
+
+    auto entry1 = new Entry();
+    entry1->setGroup(group1);
+    auto entry11 = new Entry();
+    entry11->setGroup(group11);
+    auto entry2 = new Entry();
+    entry2->setGroup(group2);
+    auto entryRoot = new Entry();
+    entryRoot->setGroup(root);
+
+    entry1->beginUpdate();
+    entry1->setTitle("entry1");
+    entry1->endUpdate();
+    QCOMPARE(entry1->historyItems().size(), 1);
+    Entry* historyItem = entry1->historyItems().first();
+
+    QList<Group*> groups;
+    root->forEachGroupRecursive([&groups](Group* group) { groups.append(group); });
+    QCOMPARE(groups, QList<Group*>({root, group1, group11, group2}));
+    QCOMPARE(groups, root->groupsRecursive(true));
+
+    QList<const Group*> constGroups;
+    const Group* constGroup1 = group1;
+    constGroup1->forEachGroupRecursive([&constGroups](const Group* group) { constGroups.append(group); }, false);
+    QCOMPARE(constGroups, QList<const Group*>({group11}));
+    QCOMPARE(constGroups, constGroup1->groupsRecursive(false));
+
+    QList<Entry*> entries;
+    root->forEachEntryRecursive([&entries](Entry* entry) { entries.append(entry); });
+    QCOMPARE(entries, QList<Entry*>({entryRoot, entry1, entry11, entry2}));
+    QCOMPARE(entries, root->entriesRecursive());
+
+    entries.clear();
+    group1->forEachEntryRecursive([&entries](Entry* entry) { entries.append(entry); }, true);
+    QCOMPARE(entries, QList<Entry*>({entry1, historyItem, entry11}));
+    QCOMPARE(entries, group1->entriesRecursive(true));
+}
+
 void TestGroup::testPrint()
 {
     QScopedPointer<Database> db(new Database());
@@ -38,6 +38,8 @@ private slots:
     void testCopyCustomIcons();
     void testFindEntry();
     void testFindGroupByPath();
+    void testFindByUuidIndex();
+    void testForEachRecursive();
     void testPrint();
     void testAddEntryWithPath();
     void testIsRecycled();
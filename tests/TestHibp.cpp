@@ -23,7 +23,9 @@
 
 #include <QBuffer>
 #include <QByteArray>
+#include <QFileInfo>
 #include <QList>
+#include <QTemporaryDir>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestHibp)
@@ -31,6 +33,9 @@ QTEST_GUILESS_MAIN(TestHibp)
 const char* TEST_HIBP_CONTENTS = "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\n" // SHA-1 of "foo"
                                  "62cdb7020ff920e5aa642c3d4066950dd1f01f4d:456\n"; // SHA-1 of "bar"
 
+const char* TEST_UNSORTED_HIBP_CONTENTS = "62CDB7020FF920E5AA642C3D4066950DD1F01F4D:456\r\n"
+                                          "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\r\n";
+
 const char* TEST_BAD_HIBP_CONTENTS = "barf:nope\n";
 
 void TestHibp::initTestCase()
@@ -118,3 +123,157 @@ void TestHibp::testPwned()
     QCOMPARE(findings[1].first, entry4);
     QCOMPARE(findings[1].second, 456);
 }
+
+namespace
+{
+    bool writeFile(const QString& path, const QByteArray& contents)
+    {
+        QFile file(path);
+        return file.open(QFile::WriteOnly) && file.write(contents) == contents.size();
+    }
+} // namespace
+
+void TestHibp::testPwnedFile()
+{
+    Group* root = m_db->rootGroup();
+
+    auto entry1 = new Entry();
+    entry1->setPassword("bar");
+    entry1->setGroup(root);
+
+    auto entry2 = new Entry();
+    entry2->setPassword("foo");
+    entry2->setGroup(root);
+
+    auto entry3 = new Entry();
+    entry3->setPassword("xyz");
+    entry3->setGroup(root);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Findings are reported in file order
+    const auto sortedPath = tempDir.filePath("sorted.txt");
+    QVERIFY(writeFile(sortedPath, TEST_HIBP_CONTENTS));
+
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QVERIFY(HibpOffline::report(m_db, sortedPath, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 2);
+    QCOMPARE(findings[0].first, entry2);
+    QCOMPARE(findings[0].second, 123);
+    QCOMPARE(findings[1].first, entry1);
+    QCOMPARE(findings[1].second, 456);
+
+    // Files ordered by prevalence
+    const auto unsortedPath = tempDir.filePath("unsorted.txt");
+    QVERIFY(writeFile(unsortedPath, TEST_UNSORTED_HIBP_CONTENTS));
+
+    findings.clear();
+    QVERIFY(HibpOffline::report(m_db, unsortedPath, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 2);
+    QCOMPARE(findings[0].first, entry1);
+    QCOMPARE(findings[1].first, entry2);
+
+    // A single line out of order in an otherwise sorted file is still found
+    QByteArray mostlySorted;
+    for (int i = 0; i < 200; ++i) {
+        mostlySorted += QByteArray::number(i, 16).rightJustified(40, '0') + ":1\n";
+    }
+    mostlySorted.insert(mostlySorted.size() / 3, QByteArray("62CDB7020FF920E5AA642C3D4066950DD1F01F4D:456\n"));
+    const auto mostlySortedPath = tempDir.filePath("mostly-sorted.txt");
+    QVERIFY(writeFile(mostlySortedPath, mostlySorted));
+
+    findings.clear();
+    QVERIFY(HibpOffline::report(m_db, mostlySortedPath, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 1);
+    QCOMPARE(findings[0].first, entry1);
+    QCOMPARE(findings[0].second, 456);
+
+    const auto badPath = tempDir.filePath("bad.txt");
+    QVERIFY(writeFile(badPath, TEST_BAD_HIBP_CONTENTS));
+
+    findings.clear();
+    QVERIFY(!HibpOffline::report(m_db, badPath, findings, &error));
+    QVERIFY(!error.isEmpty());
+    QCOMPARE(findings.size(), 0);
+
+    error.clear();
+    QVERIFY(!HibpOffline::report(m_db, tempDir.filePath("missing.txt"), findings, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestHibp::testIndex()
+{
+    Group* root = m_db->rootGroup();
+
+    auto entry1 = new Entry();
+    entry1->setPassword("foo");
+    entry1->setGroup(root);
+
+    auto entry2 = new Entry();
+    entry2->setPassword("xyz");
+    entry2->setGroup(root);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const auto hibpPath = tempDir.filePath("sorted.txt");
+    const auto indexPath = tempDir.filePath("sorted.idx");
+    QVERIFY(writeFile(hibpPath, TEST_HIBP_CONTENTS));
+
+    QString error;
+    QVERIFY(HibpOffline::buildIndex(hibpPath, indexPath, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(QFileInfo(indexPath).size(), 16 + 2 * 24);
+
+    QList<QPair<const Entry*, int>> findings;
+    QVERIFY(HibpOffline::report(m_db, indexPath, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 1);
+    QCOMPARE(findings[0].first, entry1);
+    QCOMPARE(findings[0].second, 123);
+
+    // Indexes with records out of order are scanned once the bisection runs into them.
+    // Searching for "xyz" sees the swapped records, searching for "foo" alone would miss it.
+    const auto threePath = tempDir.filePath("three.txt");
+    const auto swappedPath = tempDir.filePath("swapped.idx");
+    QVERIFY(writeFile(threePath, QByteArray("0000000000000000000000000000000000000001:1\n") + TEST_HIBP_CONTENTS));
+    QVERIFY(HibpOffline::buildIndex(threePath, swappedPath, &error));
+
+    QFile swapped(swappedPath);
+    QVERIFY(swapped.open(QFile::ReadWrite));
+    auto contents = swapped.readAll();
+    QCOMPARE(contents.size(), 16 + 3 * 24);
+    const auto fooRecord = contents.mid(40, 24);
+    contents.replace(40, 24, contents.mid(64, 24));
+    contents.replace(64, 24, fooRecord);
+    QVERIFY(swapped.seek(0));
+    QCOMPARE(swapped.write(contents), contents.size());
+    swapped.close();
+
+    findings.clear();
+    QVERIFY(HibpOffline::report(m_db, swappedPath, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 1);
+    QCOMPARE(findings[0].first, entry1);
+    QCOMPARE(findings[0].second, 123);
+
+    // Truncated index
+    QFile index(indexPath);
+    QVERIFY(index.resize(30));
+    findings.clear();
+    QVERIFY(!HibpOffline::report(m_db, indexPath, findings, &error));
+    QVERIFY(!error.isEmpty());
+
+    // The index can only be built from files ordered by hash
+    const auto unsortedPath = tempDir.filePath("unsorted.txt");
+    QVERIFY(writeFile(unsortedPath, TEST_UNSORTED_HIBP_CONTENTS));
+    error.clear();
+    QVERIFY(!HibpOffline::buildIndex(unsortedPath, tempDir.filePath("unsorted.idx"), &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!QFile::exists(tempDir.filePath("unsorted.idx")));
+}
@@ -34,6 +34,8 @@ private slots:
     void testEmpty();
     void testIoError();
     void testPwned();
+    void testPwnedFile();
+    void testIndex();
 
 private:
     QSharedPointer<Database> m_db;
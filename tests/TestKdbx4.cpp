@@ -19,6 +19,8 @@
 
 #include "config-keepassx-tests.h"
 #include "core/Metadata.h"
+#include "crypto/Random.h"
+#include "format/Kdbx4Reader.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KdbxXmlWriter.h"
 #include "format/KeePass2.h"
@@ -510,3 +512,140 @@ void TestKdbx4Format::testCustomData()
     QCOMPARE(newEntry->customData()->value(customDataKey1), customData1);
     QCOMPARE(newEntry->customData()->value(customDataKey2), customData2);
 }
+
+namespace
+{
+    QSharedPointer<Database> createPipelineDatabase(int numEntries, int attachmentSize)
+    {
+        auto db = QSharedPointer<Database>::create();
+        db->changeKdf(fastKdf(KeePass2::uuidToKdf(KeePass2::KDF_ARGON2D)));
+        auto key = QSharedPointer<CompositeKey>::create();
+        key->addKey(QSharedPointer<PasswordKey>::create("pipeline"));
+        db->setKey(key);
+
+        for (int i = 0; i < numEntries; ++i) {
+            auto entry = new Entry();
+            entry->setUuid(QUuid::createUuid());
+            entry->setTitle(QString("Entry %1").arg(i));
+            entry->setUsername(QString("user%1").arg(i));
+            entry->setPassword(QString::fromLatin1(randomGen()->randomArray(16).toHex()));
+            entry->setNotes(QString("Notes of entry %1").arg(i).repeated(20));
+            if (i % 10 == 0) {
+                entry->attachments()->set(QString("file%1.bin").arg(i), randomGen()->randomArray(attachmentSize));
+            }
+            entry->setGroup(db->rootGroup());
+        }
+        return db;
+    }
+
+    QByteArray readPipelineDatabase(QBuffer* buffer, bool pipelined, bool* ok)
+    {
+        auto key = QSharedPointer<CompositeKey>::create();
+        key->addKey(QSharedPointer<PasswordKey>::create("pipeline"));
+
+        buffer->seek(0);
+        Kdbx4Reader reader;
+        reader.setPipelined(pipelined);
+        auto db = QSharedPointer<Database>::create();
+        *ok = reader.readDatabase(buffer, key, db.data()) && !reader.hasError();
+        if (!*ok) {
+            return {};
+        }
+
+        QBuffer xml;
+        xml.open(QBuffer::ReadWrite);
+        KdbxXmlWriter writer(KeePass2::FILE_VERSION_4);
+        writer.writeDatabase(&xml, db.data());
+        return xml.data();
+    }
+} // namespace
+
+void TestKdbx4Format::testPipelinedRead_data()
+{
+    QTest::addColumn<int>("compression");
+    QTest::addColumn<int>("attachmentSize");
+
+    QTest::newRow("GZip, small attachments") << static_cast<int>(Database::CompressionGZip) << 128;
+    QTest::newRow("GZip, multi-block attachments") << static_cast<int>(Database::CompressionGZip) << 3 * 1024 * 1024;
+    QTest::newRow("No compression") << static_cast<int>(Database::CompressionNone) << 3 * 1024 * 1024;
+}
+
+void TestKdbx4Format::testPipelinedRead()
+{
+    QFETCH(int, compression);
+    QFETCH(int, attachmentSize);
+
+    auto db = createPipelineDatabase(50, attachmentSize);
+    db->setCompressionAlgorithm(static_cast<Database::CompressionAlgorithm>(compression));
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KeePass2Writer writer;
+    QVERIFY2(writer.writeDatabase(&buffer, db.data()), qPrintable(writer.errorString()));
+
+    bool ok = false;
+    auto serialXml = readPipelineDatabase(&buffer, false, &ok);
+    QVERIFY(ok);
+    auto pipelinedXml = readPipelineDatabase(&buffer, true, &ok);
+    QVERIFY(ok);
+
+    QVERIFY(!pipelinedXml.isEmpty());
+    QCOMPARE(pipelinedXml, serialXml);
+}
+
+void TestKdbx4Format::testPipelinedReadCorrupted()
+{
+    auto db = createPipelineDatabase(20, 2 * 1024 * 1024);
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KeePass2Writer writer;
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+    // flip a byte inside the second HMAC block so the failure happens mid-stream
+    auto data = buffer.data();
+    data[data.size() - 1024] = static_cast<char>(data.at(data.size() - 1024) ^ 0xFF);
+    QBuffer corrupted(&data);
+    corrupted.open(QBuffer::ReadOnly);
+
+    bool ok = true;
+    readPipelineDatabase(&corrupted, true, &ok);
+    QVERIFY(!ok);
+}
+
+void TestKdbx4Format::benchmarkPipelinedRead_data()
+{
+    QTest::addColumn<bool>("pipelined");
+
+    QTest::newRow("Serial") << false;
+    QTest::newRow("Pipelined") << true;
+}
+
+void TestKdbx4Format::benchmarkPipelinedRead()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(bool, pipelined);
+
+    auto db = createPipelineDatabase(5000, 256 * 1024);
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    KeePass2Writer writer;
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("pipeline"));
+
+    QBENCHMARK
+    {
+        buffer.seek(0);
+        Kdbx4Reader reader;
+        reader.setPipelined(pipelined);
+        Database readDb;
+        QVERIFY(reader.readDatabase(&buffer, key, &readDb));
+    };
+}
@@ -65,6 +65,11 @@ private slots:
     void testUpgradeMasterKeyIntegrity();
     void testUpgradeMasterKeyIntegrity_data();
     void testCustomData();
+    void testPipelinedRead();
+    void testPipelinedRead_data();
+    void testPipelinedReadCorrupted();
+    void benchmarkPipelinedRead();
+    void benchmarkPipelinedRead_data();
 };
 
 #endif // KEEPASSXC_TEST_KDBX4_H
@@ -1348,6 +1348,103 @@ void TestMerge::testDeletedRevertedGroup()
     QVERIFY(group2DestinationMerged->notes() == "Updated");
 }
 
+/**
+ * Nested groups deleted in the source are removed in a single pass,
+ * regardless of the order in which the deletions were recorded.
+ */
+void TestMerge::testDeletedNestedGroups()
+{
+    QScopedPointer<Database> dbDestination(createTestDatabase());
+
+    auto group3 = new Group();
+    group3->setName("group3");
+    group3->setUuid(QUuid::createUuid());
+    group3->setParent(dbDestination->rootGroup()->findChildByName("group2"));
+    auto group4 = new Group();
+    group4->setName("group4");
+    group4->setUuid(QUuid::createUuid());
+    group4->setParent(group3);
+
+    QScopedPointer<Database> dbSource(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneNoFlags, Group::CloneIncludeEntries));
+
+    m_clock->advanceSecond(1);
+
+    // Record the deletion of the parents before the deletion of their children
+    QPointer<Group> group2SourceInitial = dbSource->rootGroup()->findChildByName("group2");
+    QVERIFY(group2SourceInitial != nullptr);
+    const QUuid group2Uuid = group2SourceInitial->uuid();
+    const QUuid group3Uuid = group3->uuid();
+    const QUuid group4Uuid = group4->uuid();
+    QList<DeletedObject> deletions;
+    for (const QUuid& uuid : {group2Uuid, group3Uuid, group4Uuid}) {
+        DeletedObject deletion;
+        deletion.uuid = uuid;
+        deletion.deletionTime = Clock::currentDateTimeUtc();
+        deletions << deletion;
+    }
+    delete group2SourceInitial;
+    dbSource->setDeletedObjects(deletions);
+
+    m_clock->advanceSecond(1);
+
+    Merger merger(dbSource.data(), dbDestination.data());
+    const QStringList changes = merger.merge();
+
+    QVERIFY(!dbDestination->rootGroup()->findChildByName("group2"));
+    QVERIFY(!dbDestination->rootGroup()->findGroupByUuid(group3Uuid));
+    QVERIFY(!dbDestination->rootGroup()->findGroupByUuid(group4Uuid));
+    QVERIFY(dbDestination->containsDeletedObject(group2Uuid));
+    QVERIFY(dbDestination->containsDeletedObject(group3Uuid));
+    QVERIFY(dbDestination->containsDeletedObject(group4Uuid));
+    QVERIFY(!changes.isEmpty());
+
+    QPointer<Group> group1DestinationMerged = dbDestination->rootGroup()->findChildByName("group1");
+    QVERIFY(group1DestinationMerged);
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), 2);
+}
+
+/**
+ * Entries which are identical on both sides are left untouched by the merge,
+ * while changes to single entries are still picked up.
+ */
+void TestMerge::testMergeUnchangedEntries()
+{
+    QScopedPointer<Database> dbDestination(createTestDatabase());
+    QScopedPointer<Database> dbSource(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+
+    QPointer<Entry> entry1DestinationInitial = dbDestination->rootGroup()->findEntryByPath("entry1");
+    QVERIFY(entry1DestinationInitial != nullptr);
+    QPointer<Entry> entry2DestinationInitial = dbDestination->rootGroup()->findEntryByPath("entry2");
+    QVERIFY(entry2DestinationInitial != nullptr);
+    QList<Entry*> entry1HistoryInitial = entry1DestinationInitial->historyItems();
+
+    m_clock->advanceSecond(1);
+
+    Merger merger1(dbSource.data(), dbDestination.data());
+    QCOMPARE(merger1.merge(), QStringList());
+    QCOMPARE(dbDestination->rootGroup()->findEntryByPath("entry1"), entry1DestinationInitial.data());
+    QCOMPARE(dbDestination->rootGroup()->findEntryByPath("entry2"), entry2DestinationInitial.data());
+    QCOMPARE(entry1DestinationInitial->historyItems(), entry1HistoryInitial);
+
+    m_clock->advanceSecond(1);
+
+    Entry* entry2Source = dbSource->rootGroup()->findEntryByPath("entry2");
+    entry2Source->beginUpdate();
+    entry2Source->setPassword("updated");
+    entry2Source->endUpdate();
+
+    m_clock->advanceSecond(1);
+
+    Merger merger2(dbSource.data(), dbDestination.data());
+    const QStringList changes = merger2.merge();
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(dbDestination->rootGroup()->findEntryByPath("entry1"), entry1DestinationInitial.data());
+    QCOMPARE(entry1DestinationInitial->historyItems(), entry1HistoryInitial);
+    QCOMPARE(dbDestination->rootGroup()->findEntryByPath("entry2")->password(), QString("updated"));
+}
+
 /**
  * If the group is updated in the source database, and the
  * destination database after, the group should remain the
@@ -55,6 +55,8 @@ private slots:
     void testDeletedGroup();
     void testDeletedRevertedEntry();
     void testDeletedRevertedGroup();
+    void testDeletedNestedGroups();
+    void testMergeUnchangedEntries();
 
 private:
     Database* createTestDatabase();
@@ -0,0 +1,200 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestNativeMessagingProxy.h"
+
+#include "browser/BrowserHost.h"
+#include "browser/BrowserShared.h"
+
+#include <QEventLoop>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QTest>
+#include <QTimer>
+
+#include <cstring>
+
+QTEST_GUILESS_MAIN(TestNativeMessagingProxy)
+
+namespace
+{
+    const int Timeout = 5000;
+} // namespace
+
+void TestNativeMessagingProxy::initTestCase()
+{
+    // Keep the socket of the echo server away from a running instance
+    QVERIFY(m_runtimeDir.isValid());
+    qputenv("XDG_RUNTIME_DIR", m_runtimeDir.path().toLocal8Bit());
+
+    const auto serverPath = BrowserShared::localServerPath();
+    QLocalServer::removeServer(serverPath);
+    QVERIFY(m_server.listen(serverPath));
+
+    // Stand-in for BrowserHost, every message is sent back as is
+    connect(&m_server, &QLocalServer::newConnection, this, [this] {
+        m_client = m_server.nextPendingConnection();
+        connect(m_client, &QLocalSocket::readyRead, m_client, [this] { m_client->write(m_client->readAll()); });
+    });
+}
+
+void TestNativeMessagingProxy::init()
+{
+    // testBackToBackMessages closes the echo server
+    if (!m_server.isListening()) {
+        QLocalServer::removeServer(BrowserShared::localServerPath());
+        QVERIFY(m_server.listen(BrowserShared::localServerPath()));
+    }
+
+    m_proxy.start(KEEPASSXC_PROXY_PATH, QStringList());
+    QVERIFY(m_proxy.waitForStarted(Timeout));
+    QTRY_VERIFY_WITH_TIMEOUT(m_client, Timeout);
+}
+
+void TestNativeMessagingProxy::cleanup()
+{
+    if (m_proxy.state() != QProcess::NotRunning) {
+        m_proxy.kill();
+        m_proxy.waitForFinished(Timeout);
+    }
+    delete m_client;
+}
+
+/**
+ * Send one message to the proxy and wait for the framed reply of the echo server.
+ */
+bool TestNativeMessagingProxy::roundTrip(const QByteArray& message, QByteArray& reply)
+{
+    const auto length = static_cast<quint32>(message.size());
+    m_proxy.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    m_proxy.write(message);
+
+    QByteArray received;
+    QEventLoop loop;
+    QTimer::singleShot(Timeout, &loop, &QEventLoop::quit);
+    auto readReply = [&] {
+        received.append(m_proxy.readAllStandardOutput());
+        if (received.size() >= static_cast<int>(sizeof(quint32))) {
+            quint32 replyLength;
+            memcpy(&replyLength, received.constData(), sizeof(replyLength));
+            if (received.size() >= static_cast<int>(sizeof(quint32) + replyLength)) {
+                loop.quit();
+            }
+        }
+    };
+    connect(&m_proxy, &QProcess::readyReadStandardOutput, &loop, readReply);
+    loop.exec();
+
+    if (received.size() < static_cast<int>(sizeof(quint32))) {
+        return false;
+    }
+    reply = received.mid(sizeof(quint32));
+    return true;
+}
+
+void TestNativeMessagingProxy::testEcho()
+{
+    const QList<QByteArray> messages{
+        R"({"action":"change-public-keys","publicKey":"Lg0Y2/JUeb23Wdbo1uY0s+YvmCqtmVXdFeOYmK2FAGM="})",
+        QString(R"({"action":"get-logins","url":"https://bücher.example"})").toUtf8(),
+        QByteArray(4096, 'x')};
+
+    for (const auto& message : messages) {
+        QByteArray reply;
+        QVERIFY(roundTrip(message, reply));
+        QCOMPARE(reply, message);
+    }
+}
+
+void TestNativeMessagingProxy::testDisconnect()
+{
+    // The proxy exits once the browser closes its end of the pipe
+    m_proxy.closeWriteChannel();
+    QVERIFY(m_proxy.waitForFinished(Timeout));
+    QCOMPARE(m_proxy.exitStatus(), QProcess::NormalExit);
+}
+
+void TestNativeMessagingProxy::testBackToBackMessages()
+{
+    // Run a proxy against the real host, it answers every request with the request itself
+    m_server.close();
+    BrowserHost host;
+    host.start();
+    connect(&host, &BrowserHost::clientMessageReceived, &host, [&host](QLocalSocket* socket, const QJsonObject& json) {
+        host.sendClientMessage(socket, json);
+    });
+
+    QProcess proxy;
+    proxy.start(KEEPASSXC_PROXY_PATH, QStringList());
+    QVERIFY(proxy.waitForStarted(Timeout));
+
+    // Both requests are written at once, without waiting for the first reply
+    const QList<QByteArray> messages{R"({"action":"get-databasehash","requestID":"1"})",
+                                     R"({"action":"get-databasehash","requestID":"2"})"};
+    QByteArray input;
+    for (const auto& message : messages) {
+        const auto length = static_cast<quint32>(message.size());
+        input.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        input.append(message);
+    }
+    proxy.write(input);
+
+    QList<QByteArray> replies;
+    QByteArray received;
+    QEventLoop loop;
+    QTimer::singleShot(Timeout, &loop, &QEventLoop::quit);
+    connect(&proxy, &QProcess::readyReadStandardOutput, &loop, [&] {
+        received.append(proxy.readAllStandardOutput());
+        quint32 replyLength;
+        while (received.size() >= static_cast<int>(sizeof(replyLength))) {
+            memcpy(&replyLength, received.constData(), sizeof(replyLength));
+            if (received.size() < static_cast<int>(sizeof(replyLength) + replyLength)) {
+                break;
+            }
+            replies.append(received.mid(sizeof(replyLength), replyLength));
+            received.remove(0, sizeof(replyLength) + replyLength);
+        }
+        if (replies.size() >= messages.size()) {
+            loop.quit();
+        }
+    });
+    loop.exec();
+
+    proxy.kill();
+    proxy.waitForFinished(Timeout);
+
+    QCOMPARE(replies.size(), messages.size());
+    for (int i = 0; i < messages.size(); ++i) {
+        QCOMPARE(QJsonDocument::fromJson(replies[i]), QJsonDocument::fromJson(messages[i]));
+    }
+}
+
+void TestNativeMessagingProxy::benchmarkRoundTrip()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    const QByteArray message(R"({"action":"get-logins","nonce":"zRKdvTjL5bgWaKMCTut/8soM/uoMrFoZ"})");
+    QBENCHMARK
+    {
+        QByteArray reply;
+        QVERIFY(roundTrip(message, reply));
+    };
+}
@@ -17,7 +17,9 @@
 
 #include "TestPasswordHealth.h"
 
+#include "core/Group.h"
 #include "core/PasswordHealth.h"
+#include "crypto/Crypto.h"
 
 #include <QTest>
 
@@ -25,6 +27,7 @@ QTEST_GUILESS_MAIN(TestPasswordHealth)
 
 void TestPasswordHealth::initTestCase()
 {
+    QVERIFY(Crypto::init());
 }
 
 void TestPasswordHealth::testNoDb()
@@ -64,3 +67,41 @@ void TestPasswordHealth::testNoDb()
     QVERIFY(excellent.scoreReason().isEmpty());
     QVERIFY(excellent.scoreDetails().isEmpty());
 }
+
+void TestPasswordHealth::testCachedEntropy()
+{
+    const QStringList passwords = {"", "secret", "Yohb2ChR4", "MIhIN9UKrgtPL2hp", QString(300, 'x')};
+    for (const auto& pwd : passwords) {
+        const auto entropy = PasswordHealth::estimateEntropy(pwd);
+        QCOMPARE(PasswordHealth::cachedEntropy(pwd), entropy);
+        // Second call is served from the cache
+        QCOMPARE(PasswordHealth::cachedEntropy(pwd), entropy);
+    }
+}
+
+void TestPasswordHealth::testEvaluateEntries()
+{
+    auto db = QSharedPointer<Database>::create();
+
+    const QStringList passwords = {"secret", "MIhIN9UKrgtPL2hp", "secret", "Yohb2ChR4"};
+    QList<const Entry*> entries;
+    for (const auto& pwd : passwords) {
+        auto entry = new Entry();
+        entry->setPassword(pwd);
+        entry->setGroup(db->rootGroup());
+        entries.append(entry);
+    }
+
+    const HealthChecker checker(db);
+    const auto healths = checker.evaluate(entries);
+    QCOMPARE(healths.size(), entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        const auto expected = checker.evaluate(entries[i]);
+        QCOMPARE(healths[i]->score(), expected->score());
+        QCOMPARE(healths[i]->scoreReason(), expected->scoreReason());
+    }
+
+    // Re-used passwords are penalized
+    QVERIFY(healths[0]->score() < PasswordHealth(passwords[0]).score());
+    QCOMPARE(healths[1]->score(), PasswordHealth(passwords[1]).score());
+}
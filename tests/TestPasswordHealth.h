@@ -27,6 +27,8 @@ class TestPasswordHealth : public QObject
 private slots:
     void initTestCase();
     void testNoDb();
+    void testCachedEntropy();
+    void testEvaluateEntries();
 };
 
 #endif // KEEPASSX_TESTPASSWORDHEALTH_H
@@ -18,11 +18,13 @@
 #include "TestSSHAgent.h"
 #include "config-keepassx-tests.h"
 #include "core/Config.h"
+#include "core/Group.h"
 #include "crypto/Crypto.h"
 #include "sshagent/KeeAgentSettings.h"
 #include "sshagent/OpenSSHKeyGen.h"
 #include "sshagent/SSHAgent.h"
 
+#include <QSignalSpy>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestSSHAgent)
@@ -225,6 +227,69 @@ void TestSSHAgent::testToOpenSSHKey()
     QVERIFY(!key.publicKey().isEmpty());
 }
 
+void TestSSHAgent::testDatabaseUnlocked()
+{
+    SSHAgent agent;
+    agent.setEnabled(true);
+    agent.setAuthSockOverride(m_agentSocketFileName);
+
+    QVERIFY(agent.isAgentRunning());
+
+    auto db = QSharedPointer<Database>::create();
+    QList<QSharedPointer<OpenSSHKey>> keys;
+
+    for (int i = 0; i < 4; ++i) {
+        auto key = QSharedPointer<OpenSSHKey>::create();
+        QVERIFY(OpenSSHKeyGen::generateEd25519(*key));
+        keys.append(key);
+
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setUsername(QString("user%1").arg(i));
+        entry->attachments()->set("id_ed25519", key->privateKey().toUtf8());
+        entry->setGroup(db->rootGroup());
+
+        KeeAgentSettings settings;
+        settings.setAllowUseOfSshKey(true);
+        settings.setAddAtDatabaseOpen(true);
+        settings.setRemoveAtDatabaseClose(true);
+        settings.setSelectedType("attachment");
+        settings.setAttachmentName("id_ed25519");
+        settings.toEntry(entry);
+    }
+
+    // an unreadable key is skipped without affecting the others
+    auto brokenEntry = new Entry();
+    brokenEntry->setUuid(QUuid::createUuid());
+    brokenEntry->attachments()->set("id_ed25519", "not a key");
+    brokenEntry->setGroup(db->rootGroup());
+
+    KeeAgentSettings brokenSettings;
+    brokenSettings.setAllowUseOfSshKey(true);
+    brokenSettings.setAddAtDatabaseOpen(true);
+    brokenSettings.setSelectedType("attachment");
+    brokenSettings.setAttachmentName("id_ed25519");
+    brokenSettings.toEntry(brokenEntry);
+
+    QSignalSpy errorSpy(&agent, SIGNAL(error(QString)));
+    bool keyInAgent;
+
+    agent.databaseUnlocked(db);
+    QCOMPARE(errorSpy.count(), 0);
+    for (const auto& key : asConst(keys)) {
+        QVERIFY(agent.checkIdentity(*key, keyInAgent) && keyInAgent);
+    }
+
+    // unlocking again re-adds the known keys over the same connection
+    agent.databaseUnlocked(db);
+    QCOMPARE(errorSpy.count(), 0);
+
+    agent.databaseLocked(db);
+    for (const auto& key : asConst(keys)) {
+        QVERIFY(agent.checkIdentity(*key, keyInAgent) && !keyInAgent);
+    }
+}
+
 void TestSSHAgent::testKeyGenRSA()
 {
     SSHAgent agent;
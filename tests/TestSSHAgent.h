@@ -35,6 +35,7 @@ private slots:
     void testLifetimeConstraint();
     void testConfirmConstraint();
     void testToOpenSSHKey();
+    void testDatabaseUnlocked();
     void testKeyGenRSA();
     void testKeyGenECDSA();
     void testKeyGenEd25519();
@@ -20,6 +20,7 @@
 #include "core/Clock.h"
 
 #include <QRegularExpression>
+#include <QTemporaryDir>
 #include <QTest>
 #include <QUuid>
 
@@ -165,6 +166,76 @@ void TestTools::testBackupFilePatternSubstitution()
     QCOMPARE(Tools::substituteBackupFilePath(pattern, dbFilePath), expectedSubstitution);
 }
 
+void TestTools::testPruneBackupFiles()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir dir(tempDir.path());
+
+    auto touch = [&](const QString& fileName, int age) {
+        QFile file(dir.filePath(fileName));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("backup");
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(-age), QFileDevice::FileModificationTime));
+    };
+
+    auto dbPath = dir.filePath("db.kdbx");
+    touch("db.kdbx", 0);
+    touch("db.old.kdbx", 0);
+    // Modification times are the reverse of the timestamps in the names
+    for (int i = 1; i <= 5; ++i) {
+        touch(QString("db_2024010%1.old.kdbx").arg(i), 100 * i);
+    }
+    // Similarly named files that are not backups of this database
+    touch("db_work.old.kdbx", 1000);
+    touch("db_2024010.old.kdbx", 1000);
+    touch("db_20241399.old.kdbx", 1000);
+    touch("db_20240101.old.kdbx.tmp", 1000);
+    touch("other_20240101.old.kdbx", 1000);
+
+    // Backups without a timestamp are overwritten and never rotated
+    QVERIFY(Tools::pruneBackupFiles("{DB_FILENAME}.old.kdbx", dbPath, 1).isEmpty());
+
+    // Nothing is removed without a limit
+    QVERIFY(Tools::pruneBackupFiles("{DB_FILENAME}_{TIME}.old.kdbx", dbPath, 0).isEmpty());
+
+    // The backups with the oldest timestamps are removed
+    auto removed = Tools::pruneBackupFiles("{DB_FILENAME}_{TIME:yyyyMMdd}.old.kdbx", dbPath, 3);
+    removed.sort();
+    QCOMPARE(removed,
+             QStringList({dir.filePath("db_20240101.old.kdbx"), dir.filePath("db_20240102.old.kdbx")}));
+    for (const auto& fileName : {"db_20240103.old.kdbx",
+                                 "db_20240104.old.kdbx",
+                                 "db_20240105.old.kdbx",
+                                 "db_work.old.kdbx",
+                                 "db_2024010.old.kdbx",
+                                 "db_20241399.old.kdbx",
+                                 "db_20240101.old.kdbx.tmp",
+                                 "other_20240101.old.kdbx",
+                                 "db.old.kdbx",
+                                 "db.kdbx"}) {
+        QVERIFY2(dir.exists(fileName), fileName);
+    }
+
+    // The default format only matches its own timestamps
+    touch("db_02_01_2024_10-00-00.kdbx", 20);
+    touch("db_01_02_2024_10-00-00.kdbx", 10);
+    touch("db_work.kdbx", 30);
+    removed = Tools::pruneBackupFiles("{DB_FILENAME}_{TIME}.kdbx", dbPath, 1);
+    QCOMPARE(removed, QStringList({dir.filePath("db_02_01_2024_10-00-00.kdbx")}));
+    QVERIFY(dir.exists("db_work.kdbx"));
+    QVERIFY(dir.exists("db.kdbx"));
+
+    // Relative patterns are resolved against the database directory
+    dir.mkdir("backups");
+    touch("backups/db_2024-01-01.kdbx", 10);
+    touch("backups/db_2024-01-02.kdbx", 20);
+    touch("backups/db_backup.kdbx", 30);
+    removed = Tools::pruneBackupFiles("backups/{DB_FILENAME}_{TIME:yyyy-MM-dd}.kdbx", dbPath, 1);
+    QCOMPARE(removed, QStringList({dir.filePath("backups/db_2024-01-01.kdbx")}));
+    QVERIFY(dir.exists("backups/db_backup.kdbx"));
+}
+
 void TestTools::testEscapeRegex_data()
 {
     QTest::addColumn<QString>("input");
@@ -31,6 +31,7 @@ private slots:
     void testValidUuid();
     void testBackupFilePatternSubstitution_data();
     void testBackupFilePatternSubstitution();
+    void testPruneBackupFiles();
     void testEscapeRegex();
     void testEscapeRegex_data();
     void testConvertToRegex();
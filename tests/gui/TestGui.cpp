@@ -31,6 +31,7 @@
 #include <QToolBar>
 
 #include "config-keepassx-tests.h"
+#include "core/EntrySearcher.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
 #include "gui/ApplicationSettingsWidget.h"
@@ -1118,6 +1119,48 @@ void TestGui::testSearch()
     QTRY_COMPARE(m_dbWidget->currentMode(), DatabaseWidget::Mode::ViewMode);
 }
 
+void TestGui::testSearchLargeDatabase()
+{
+    // Enough entries to search on a worker thread
+    auto root = m_db->rootGroup();
+    for (int i = 0; i < 6000; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("entry %1").arg(i));
+        entry->setUsername(i % 2 ? "odd" : "even");
+        entry->setPassword(QString("password %1").arg(i));
+        entry->setGroup(root);
+    }
+
+    auto* entryView = m_dbWidget->findChild<EntryView*>("entryView");
+    auto expectedCount = [&](const QString& searchtext) {
+        return EntrySearcher().search(searchtext, root).size();
+    };
+
+    // Results arrive in batches until all matches are shown
+    m_dbWidget->search("u:odd");
+    QTRY_VERIFY(m_dbWidget->isSearchActive());
+    QTRY_COMPARE(entryView->model()->rowCount(), expectedCount("u:odd"));
+
+    // A newer search replaces one that is still running, stale batches are dropped
+    m_dbWidget->search("entry 1");
+    m_dbWidget->search("entry 2");
+    QTRY_COMPARE(entryView->model()->rowCount(), expectedCount("entry 2"));
+    QTest::qWait(100);
+    QCOMPARE(entryView->model()->rowCount(), expectedCount("entry 2"));
+
+    // Searching passwords takes a new snapshot that includes them
+    m_dbWidget->search("pw:\"password 59\"");
+    QTRY_COMPARE(entryView->model()->rowCount(), expectedCount("pw:\"password 59\""));
+
+    // Ending the search discards results that are still on their way
+    m_dbWidget->search("u:even");
+    m_dbWidget->endSearch();
+    QTest::qWait(100);
+    QVERIFY(!m_dbWidget->isSearchActive());
+    QCOMPARE(entryView->model()->rowCount(), root->entries().size());
+}
+
 void TestGui::testDeleteEntry()
 {
     // Add canned entries for consistent testing
@@ -1410,6 +1453,29 @@ void TestGui::testSave()
     checkSaveDatabase();
 }
 
+void TestGui::testSaveWhileSaving()
+{
+    m_db->metadata()->setName("testSaveWhileSaving");
+    QTRY_VERIFY(m_db->isModified());
+
+    // Edit and save again from the event loop running while the first save is written
+    bool nestedSaved = false;
+    QTimer::singleShot(0, m_dbWidget.data(), [&] {
+        QVERIFY(m_dbWidget->isSaving());
+        m_db->metadata()->setName("testSaveWhileSaving2");
+        nestedSaved = m_dbWidget->save();
+    });
+    QVERIFY(m_dbWidget->save());
+    QVERIFY(nestedSaved);
+
+    // The nested save is neither an error nor a failed attempt, it runs afterwards
+    for (auto messageWidget : m_dbWidget->findChildren<MessageWidget*>()) {
+        QVERIFY(!messageWidget->isVisible() || !messageWidget->text().contains("already in progress"));
+    }
+    QTRY_VERIFY(!m_db->isModified());
+    checkDatabase(m_dbFilePath, "testSaveWhileSaving2");
+}
+
 void TestGui::testSaveBackupPath_data()
 {
     QTest::addColumn<QString>("backupFilePathPattern");
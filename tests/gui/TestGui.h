@@ -50,6 +50,7 @@ private slots:
     void testDicewareEntryEntropy();
     void testTotp();
     void testSearch();
+    void testSearchLargeDatabase();
     void testDeleteEntry();
     void testCloneEntry();
     void testEntryPlaceholders();
@@ -58,6 +59,7 @@ private slots:
     void testSaveAs();
     void testSaveBackup();
     void testSave();
+    void testSaveWhileSaving();
     void testSaveBackupPath();
     void testSaveBackupPath_data();
     void testDatabaseSettings();
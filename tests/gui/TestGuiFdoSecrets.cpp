@@ -353,6 +353,75 @@ void TestGuiFdoSecrets::testServiceSearch()
         COMPARE(locked, {});
         COMPARE(unlocked, {});
     }
+
+    // all attributes have to match exactly
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "1"}, {crazyKey, crazyValue}}));
+        COMPARE(unlocked, {QDBusObjectPath(item->path())});
+    }
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "1"}, {crazyKey, "[v]al"}}));
+        COMPARE(unlocked, {});
+    }
+
+    // changes to the entry are reflected in the search results
+    entry->attributes()->set("fdosecrets-test", "3");
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "1"}}));
+        COMPARE(unlocked, {});
+    }
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"fdosecrets-test", "3"}}));
+        COMPARE(unlocked, {QDBusObjectPath(item->path())});
+    }
+
+    // title is matched after resolving placeholders
+    entry->setUsername("fdosecrets-test-user");
+    entry->setTitle("{USERNAME}");
+    {
+        DBUS_GET2(unlocked, locked, service->SearchItems({{"Title", "fdosecrets-test-user"}}));
+        COMPARE(unlocked, {QDBusObjectPath(item->path())});
+    }
+}
+
+void TestGuiFdoSecrets::testServiceSearchSpecialChars()
+{
+    auto entryA = new Entry();
+    entryA->setUuid(QUuid::createUuid());
+    entryA->setTitle("titleA");
+    entryA->attributes()->set("testAttribute", "OAuth::[test.name@gmail.com]");
+    entryA->setGroup(m_db->rootGroup());
+    auto entryB = new Entry();
+    entryB->setUuid(QUuid::createUuid());
+    entryB->setTitle("titleB");
+    entryB->attributes()->set("testAttribute", "Abc:*+.-");
+    entryB->attributes()->set("_a:bc&-+'-e%12df_d", "value");
+    entryB->setGroup(m_db->rootGroup());
+
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+
+    // values are matched literally, not as patterns
+    {
+        DBUS_GET(unlocked, coll->SearchItems({{"testAttribute", "OAuth::[test.name@gmail.com]"}}));
+        COMPARE(unlocked, {collObj->itemPath(entryA)});
+    }
+    {
+        DBUS_GET(unlocked, coll->SearchItems({{"testAttribute", "Abc:*+.-"}}));
+        COMPARE(unlocked, {collObj->itemPath(entryB)});
+    }
+    {
+        DBUS_GET(unlocked, coll->SearchItems({{"testAttribute", "v|"}}));
+        COMPARE(unlocked, {});
+    }
+    {
+        DBUS_GET(unlocked, coll->SearchItems({{"_a:bc&-+'-e%12df_d", "value"}}));
+        COMPARE(unlocked, {collObj->itemPath(entryB)});
+    }
 }
 
 void TestGuiFdoSecrets::testServiceSearchBlockingUnlock()
@@ -673,6 +742,48 @@ void TestGuiFdoSecrets::testServiceUnlockItems()
     DBUS_COMPARE(item->locked(), false);
 }
 
+void TestGuiFdoSecrets::testServiceUnlockItemsEvicted()
+{
+    FdoSecrets::settings()->setConfirmAccessItem(true);
+
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto item = getFirstItem(coll);
+    VERIFY(item);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+
+    DBUS_GET2(unlocked, promptPath, service->Unlock({QDBusObjectPath(item->path())}));
+    COMPARE(unlocked, {});
+
+    auto prompt = getProxy<PromptProxy>(promptPath);
+    VERIFY(prompt);
+    QSignalSpy spyPromptCompleted(prompt.data(), SIGNAL(Completed(bool, QDBusVariant)));
+    VERIFY(spyPromptCompleted.isValid());
+
+    DBUS_VERIFY(prompt->Prompt(""));
+
+    // the item is evicted while the access control dialog is open
+    QPointer<Item> itemObj = m_plugin->dbus()->pathToObject<Item>(QDBusObjectPath(item->path()));
+    VERIFY(itemObj);
+    collObj->evictIdleItems(0);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    VERIFY(!itemObj);
+
+    // the decision still applies to the entry
+    VERIFY(driveAccessControlDialog(false));
+    VERIFY(waitForSignal(spyPromptCompleted, 1));
+    {
+        auto args = spyPromptCompleted.takeFirst();
+        COMPARE(args.size(), 2);
+        COMPARE(args.at(0).toBool(), false);
+        COMPARE(getSignalVariantArgument<QList<QDBusObjectPath>>(args.at(1)), {QDBusObjectPath(item->path())});
+    }
+    DBUS_COMPARE(item->locked(), false);
+}
+
 void TestGuiFdoSecrets::testServiceUnlockItemsIncludeFutureEntries()
 {
     FdoSecrets::settings()->setConfirmAccessItem(true);
@@ -1217,6 +1328,17 @@ void TestGuiFdoSecrets::testItemChange()
         COMPARE(args.size(), 1);
         COMPARE(args.at(0).value<QDBusObjectPath>().path(), item->path());
     }
+
+    // a burst of changes is sent as a single signal
+    spyItemChanged.clear();
+    for (int i = 0; i < 20; ++i) {
+        entry->attributes()->set("abc", QString::number(i));
+    }
+    m_plugin->dbus()->flushPendingSignals();
+    QTRY_COMPARE(spyItemChanged.size(), 1);
+    COMPARE(spyItemChanged.first().at(0).value<QDBusObjectPath>().path(), item->path());
+    processEvents();
+    COMPARE(spyItemChanged.size(), 1);
 }
 
 void TestGuiFdoSecrets::testItemReplace()
@@ -1300,7 +1422,7 @@ void TestGuiFdoSecrets::testItemReplace()
             COMPARE(args.at(0).value<QDBusObjectPath>().path(), item4->path());
         }
         // there may be multiple changed signals, due to each item attribute is set separately
-        VERIFY(!spyItemChanged.isEmpty());
+        QTRY_VERIFY(!spyItemChanged.isEmpty());
         for (const auto& args : spyItemChanged) {
             COMPARE(args.size(), 1);
             COMPARE(args.at(0).value<QDBusObjectPath>().path(), item4->path());
@@ -1345,6 +1467,66 @@ void TestGuiFdoSecrets::testItemReplaceExistingLocked()
     DBUS_COMPARE(item2->label(), QStringLiteral("abc2"));
 }
 
+void TestGuiFdoSecrets::testItemReplaceExistingEvicted()
+{
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+    auto sess = openSession(service, DhIetf1024Sha256Aes128CbcPkcs7::Algorithm);
+    VERIFY(sess);
+
+    StringStringMap attr1{
+        {"application", "fdosecrets-test"},
+        {"fdosecrets-attr", "1"},
+    };
+
+    auto item = createItem(sess, coll, "abc1", "Password", attr1, false);
+    VERIFY(item);
+
+    QPointer<Item> itemObj = m_plugin->dbus()->pathToObject<Item>(QDBusObjectPath(item->path()));
+    VERIFY(itemObj);
+    FdoSecrets::settings()->setConfirmAccessItem(true);
+    m_client->setItemAuthorized(itemObj->backend()->uuid(), AuthDecision::Undecided);
+
+    // replace the locked item, which asks the user for access
+    QVariantMap properties{
+        {DBUS_INTERFACE_SECRET_ITEM + ".Label", QVariant::fromValue(QStringLiteral("abc2"))},
+        {DBUS_INTERFACE_SECRET_ITEM + ".Attributes", QVariant::fromValue(attr1)},
+    };
+    auto encrypted = encryptPassword("PasswordUpdated", "text/plain", sess);
+    DBUS_GET2(itemPath, promptPath, coll->CreateItem(properties, encrypted, true));
+    auto prompt = getProxy<PromptProxy>(promptPath);
+    VERIFY(prompt);
+    QSignalSpy spyPromptCompleted(prompt.data(), SIGNAL(Completed(bool, QDBusVariant)));
+    VERIFY(spyPromptCompleted.isValid());
+
+    DBUS_VERIFY(prompt->Prompt(""));
+    processEvents();
+
+    // the item is evicted while the access control dialog is open
+    collObj->evictIdleItems(0);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    VERIFY(!itemObj);
+
+    // the prompt still completes and updates the entry
+    VERIFY(driveAccessControlDialog());
+    VERIFY(waitForSignal(spyPromptCompleted, 1));
+    auto args = spyPromptCompleted.takeFirst();
+    COMPARE(args.size(), 2);
+    COMPARE(args.at(0).toBool(), false);
+    COMPARE(getSignalVariantArgument<QDBusObjectPath>(args.at(1)).path(), item->path());
+
+    DBUS_COMPARE(item->label(), QStringLiteral("abc2"));
+    {
+        DBUS_GET(ss, item->GetSecret(QDBusObjectPath(sess->path())));
+        auto decrypted = m_clientCipher->decrypt(ss.unmarshal(m_plugin->dbus()));
+        COMPARE(decrypted.value, QByteArrayLiteral("PasswordUpdated"));
+    }
+}
+
 void TestGuiFdoSecrets::testItemSecret()
 {
     const QString TEXT_PLAIN = "text/plain";
@@ -1457,6 +1639,46 @@ void TestGuiFdoSecrets::testItemDelete()
     COMPARE(args.at(0).value<QDBusObjectPath>().path(), itemPath);
 }
 
+void TestGuiFdoSecrets::testItemDeleteEvicted()
+{
+    FdoSecrets::settings()->setConfirmDeleteItem(true);
+
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+    auto item = getFirstItem(coll);
+    VERIFY(item);
+    QPointer<Item> itemObj = m_plugin->dbus()->pathToObject<Item>(QDBusObjectPath(item->path()));
+    VERIFY(itemObj);
+    const auto uuid = itemObj->backend()->uuid();
+
+    DBUS_GET(promptPath, item->Delete());
+    auto prompt = getProxy<PromptProxy>(promptPath);
+    VERIFY(prompt);
+    QSignalSpy spyPromptCompleted(prompt.data(), SIGNAL(Completed(bool, QDBusVariant)));
+    VERIFY(spyPromptCompleted.isValid());
+
+    // the item is evicted while the prompt is pending
+    collObj->evictIdleItems(0);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    VERIFY(!itemObj);
+
+    // the entry is still deleted
+    MessageBox::setNextAnswer(MessageBox::Delete);
+    DBUS_VERIFY(prompt->Prompt(""));
+    VERIFY(waitForSignal(spyPromptCompleted, 1));
+    auto args = spyPromptCompleted.takeFirst();
+    COMPARE(args.count(), 2);
+    COMPARE(args.at(0).toBool(), false);
+
+    auto entry = m_db->rootGroup()->findEntryByUuid(uuid);
+    VERIFY(!entry || entry->isRecycled());
+    VERIFY(!collObj->itemIds().contains(Tools::uuidToHex(uuid)));
+}
+
 void TestGuiFdoSecrets::testItemLockState()
 {
     auto service = enableService();
@@ -1560,6 +1782,50 @@ void TestGuiFdoSecrets::testItemRejectSetReferenceFields()
     }
 }
 
+void TestGuiFdoSecrets::testItemLazyCreation()
+{
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+
+    auto entry = m_db->rootGroup()->entries().first();
+    VERIFY(entry);
+    const auto itemPath = collObj->itemPath(entry);
+    COMPARE(itemPath.path(), QStringLiteral("%1/%2").arg(coll->path(), entry->uuidToHex()));
+    VERIFY(collObj->itemIds().contains(entry->uuidToHex()));
+
+    // drop all items, the path keeps working and recreates the item
+    collObj->evictIdleItems(0);
+    QPointer<Item> itemObj = m_plugin->dbus()->pathToObject<Item>(itemPath);
+    VERIFY(itemObj);
+    auto item = getProxy<ItemProxy>(itemPath);
+    VERIFY(item);
+    DBUS_COMPARE(item->label(), entry->title());
+
+    // recently used items are kept
+    collObj->evictIdleItems(Collection::ItemIdleTimeout);
+    QCoreApplication::processEvents(QEventLoop::AllEvents);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    VERIFY(itemObj);
+
+    // evicted items do not look deleted to clients
+    QSignalSpy spyItemDeleted(coll.data(), SIGNAL(ItemDeleted(QDBusObjectPath)));
+    VERIFY(spyItemDeleted.isValid());
+    collObj->evictIdleItems(0);
+    QCoreApplication::processEvents(QEventLoop::AllEvents);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    VERIFY(!itemObj);
+    DBUS_COMPARE(item->label(), entry->title());
+    VERIFY(spyItemDeleted.isEmpty());
+
+    // unknown uuids are not turned into items
+    const QDBusObjectPath unknownPath(QStringLiteral("%1/%2").arg(coll->path(), Tools::uuidToHex(QUuid::createUuid())));
+    VERIFY(!m_plugin->dbus()->pathToObject<Item>(unknownPath));
+}
+
 void TestGuiFdoSecrets::testAlias()
 {
     auto service = enableService();
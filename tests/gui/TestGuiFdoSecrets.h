@@ -66,12 +66,14 @@ private slots:
     void testServiceEnable();
     void testServiceEnableNoExposedDatabase();
     void testServiceSearch();
+    void testServiceSearchSpecialChars();
     void testServiceSearchBlockingUnlock();
     void testServiceSearchBlockingUnlockMultiple();
     void testServiceSearchForce();
     void testServiceUnlock();
     void testServiceUnlockDatabaseConcurrent();
     void testServiceUnlockItems();
+    void testServiceUnlockItemsEvicted();
     void testServiceUnlockItemsIncludeFutureEntries();
     void testServiceLock();
     void testServiceLockConcurrent();
@@ -89,10 +91,13 @@ private slots:
     void testItemChange();
     void testItemReplace();
     void testItemReplaceExistingLocked();
+    void testItemReplaceExistingEvicted();
     void testItemSecret();
     void testItemDelete();
+    void testItemDeleteEvicted();
     void testItemLockState();
     void testItemRejectSetReferenceFields();
+    void testItemLazyCreation();
 
     void testAlias();
     void testDefaultAliasAlwaysPresent();
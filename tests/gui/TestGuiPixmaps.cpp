@@ -81,4 +81,34 @@ void TestGuiPixmaps::testGroupIcons()
     QVERIFY(Icons::groupIconPixmap(group).toImage() == Icons::customIconPixmap(db.data(), iconUuid).toImage());
 }
 
+void TestGuiPixmaps::testCustomIconCache()
+{
+    QScopedPointer<Database> db(new Database());
+
+    QUuid iconUuid = QUuid::createUuid();
+    QImage icon(1, 1, QImage::Format_RGB32);
+    icon.setPixel(0, 0, qRgb(0, 0, 0));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+
+    // Repeated lookups return the same decoded pixmap
+    auto pixmap = Icons::customIconPixmap(db.data(), iconUuid);
+    QVERIFY(!pixmap.isNull());
+    QCOMPARE(Icons::customIconPixmap(db.data(), iconUuid).cacheKey(), pixmap.cacheKey());
+    QVERIFY(Icons::customIconPixmap(db.data(), iconUuid, IconSize::Large).cacheKey() != pixmap.cacheKey());
+
+    // Replacing the icon data invalidates the cached pixmap
+    db->metadata()->removeCustomIcon(iconUuid);
+    QVERIFY(Icons::customIconPixmap(db.data(), iconUuid).isNull());
+    icon.setPixel(0, 0, qRgb(255, 255, 255));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+    auto replacedPixmap = Icons::customIconPixmap(db.data(), iconUuid);
+    QVERIFY(replacedPixmap.cacheKey() != pixmap.cacheKey());
+    QVERIFY(replacedPixmap.toImage() != pixmap.toImage());
+
+    // The same icon in another database is cached separately
+    QScopedPointer<Database> otherDb(new Database());
+    otherDb->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+    QVERIFY(Icons::customIconPixmap(otherDb.data(), iconUuid).cacheKey() != replacedPixmap.cacheKey());
+}
+
 QTEST_MAIN(TestGuiPixmaps)